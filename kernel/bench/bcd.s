@@ -0,0 +1,49 @@
+; DT65PC guest benchmark: BCD arithmetic
+; Copyright (C) 2026 David Terhune
+;
+; Decimal-mode sums and differences, 16-bit and 8-bit, 20000 times.
+; Result: low word of the 16-bit decimal sum.
+
+.include "common.s"
+
+COUNT = 20000
+
+sum   = b_zero
+diff  = b_zero + 4
+small = b_zero + 6
+
+    bench_start
+    stz sum
+    stz sum + 2
+    stz diff
+    stz small
+    sed
+    ldx #COUNT
+
+next:
+    lda sum
+    clc
+    adc #$1234
+    sta sum
+    lda sum + 2
+    adc #0
+    sta sum + 2
+
+    lda diff
+    sec
+    sbc #$0789
+    sta diff
+
+    set8a
+    lda small
+    clc
+    adc #$47
+    sta small
+    set16a
+
+    dex
+    bne next
+
+    cld
+    lda sum
+    stp
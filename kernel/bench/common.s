@@ -0,0 +1,27 @@
+; DT65PC guest benchmark common definitions
+; Copyright (C) 2026 David Terhune
+;
+; Benchmarks are loaded into RAM at $1000 and started there. Each one
+; finishes with STP, leaving a result in the accumulator that can be
+; checked against the value noted in its source.
+
+.p816
+.feature string_escapes
+
+    .org $1000
+
+.include "macros.s"
+.include "zeropage.s"
+
+; Benchmark variables start above the kernel zero-page storage.
+b_zero = $40
+
+; Switch to native mode with 16-bit registers and put the stack just
+; below the program.
+.macro bench_start
+    clc
+    xce
+    set16ai
+    lda #$0FFF
+    tcs
+.endmac
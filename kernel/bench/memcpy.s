@@ -0,0 +1,51 @@
+; DT65PC guest benchmark: memory copy loops
+; Copyright (C) 2026 David Terhune
+;
+; Copies 32K from bank 1 to bank 2 a word at a time, first with long
+; indexed addressing and then through long indirect pointers, eight
+; passes. Needs at least three banks of RAM.
+; Result: 0.
+
+.include "common.s"
+
+BYTES  = $8000
+PASSES = 8
+
+src  = b_zero
+dst  = b_zero + 4
+pass = b_zero + 8
+
+    bench_start
+    lda #PASSES
+    sta pass
+
+next_pass:
+    ldx #0
+long_copy:
+    lda $010000,x
+    sta $020000,x
+    inx
+    inx
+    cpx #BYTES
+    bne long_copy
+
+    stz src
+    lda #$0001
+    sta src + 2
+    stz dst
+    lda #$0002
+    sta dst + 2
+    ldy #0
+pointer_copy:
+    lda [src],y
+    sta [dst],y
+    iny
+    iny
+    cpy #BYTES
+    bne pointer_copy
+
+    dec pass
+    bne next_pass
+
+    lda #0
+    stp
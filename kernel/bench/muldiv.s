@@ -0,0 +1,123 @@
+; DT65PC guest benchmark: 32-bit multiply and divide
+; Copyright (C) 2026 David Terhune
+;
+; For n from 1 to 1000, multiplies n by $12345 and divides the product
+; by n + 7, summing quotients and remainders. All shift-and-add.
+; Result: low word of the sum.
+
+.include "common.s"
+
+COUNT = 1000
+
+mul_a = b_zero          ; multiplicand
+mul_b = b_zero + 4      ; multiplier
+prod  = b_zero + 8      ; product
+dvd   = b_zero + 12     ; dividend, then quotient
+dvs   = b_zero + 16     ; divisor
+rem   = b_zero + 20     ; remainder
+n     = b_zero + 24
+sum   = b_zero + 26
+
+    bench_start
+    stz sum
+    stz sum + 2
+    lda #1
+    sta n
+
+next_n:
+    lda n
+    sta mul_a
+    stz mul_a + 2
+    lda #$2345
+    sta mul_b
+    lda #$0001
+    sta mul_b + 2
+    jsr mul32
+
+    lda prod
+    sta dvd
+    lda prod + 2
+    sta dvd + 2
+    lda n
+    clc
+    adc #7
+    sta dvs
+    stz dvs + 2
+    jsr div32
+
+    lda sum
+    clc
+    adc dvd
+    sta sum
+    lda sum + 2
+    adc dvd + 2
+    sta sum + 2
+    lda sum
+    clc
+    adc rem
+    sta sum
+    lda sum + 2
+    adc rem + 2
+    sta sum + 2
+
+    inc n
+    lda n
+    cmp #COUNT + 1
+    bne next_n
+
+    lda sum
+    stp
+
+;======================================================================
+; prod = mul_a * mul_b, low 32 bits. Clobbers mul_a, mul_b and X.
+;======================================================================
+.proc mul32
+    stz prod
+    stz prod + 2
+    ldx #32
+next_bit:
+    lsr mul_b + 2
+    ror mul_b
+    bcc no_add
+    lda prod
+    clc
+    adc mul_a
+    sta prod
+    lda prod + 2
+    adc mul_a + 2
+    sta prod + 2
+no_add:
+    asl mul_a
+    rol mul_a + 2
+    dex
+    bne next_bit
+    rts
+.endproc
+
+;======================================================================
+; dvd = dvd / dvs and rem = dvd % dvs, unsigned. Clobbers X and Y.
+;======================================================================
+.proc div32
+    stz rem
+    stz rem + 2
+    ldx #32
+next_bit:
+    asl dvd
+    rol dvd + 2
+    rol rem
+    rol rem + 2
+    lda rem
+    sec
+    sbc dvs
+    tay
+    lda rem + 2
+    sbc dvs + 2
+    bcc no_sub
+    sta rem + 2
+    sty rem
+    inc dvd             ; quotient bit, free after the shift
+no_sub:
+    dex
+    bne next_bit
+    rts
+.endproc
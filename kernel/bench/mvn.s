@@ -0,0 +1,32 @@
+; DT65PC guest benchmark: MVN bank copies
+; Copyright (C) 2026 David Terhune
+;
+; Copies a full 64K bank between banks 2 and 3 with one MVN, sixteen
+; passes. Needs at least four banks of RAM.
+; Result: 0.
+
+.include "common.s"
+
+PASSES = 16
+
+pass = b_zero
+
+    bench_start
+    lda #PASSES
+    sta pass
+
+next_pass:
+    lda #$FFFF          ; byte count - 1
+    ldx #0
+    ldy #0
+    mvn $02,$03
+
+    ; MVN leaves the data bank at the destination.
+    phk
+    plb
+
+    dec pass
+    bne next_pass
+
+    lda #0
+    stp
@@ -0,0 +1,74 @@
+; DT65PC guest benchmark: Sieve of Eratosthenes
+; Copyright (C) 2026 David Terhune
+;
+; The classic byte sieve over 8191 odd numbers, ten passes.
+; Result: 1899 ($076B) primes.
+
+.include "common.s"
+
+SIZE   = 8190
+PASSES = 10
+flags  = $4000
+
+prime = b_zero
+count = b_zero + 2
+pass  = b_zero + 4
+
+    bench_start
+    lda #PASSES
+    sta pass
+
+next_pass:
+    ; Set every flag, two at a time.
+    lda #$0101
+    ldx #0
+fill:
+    sta flags,x
+    inx
+    inx
+    cpx #SIZE + 2
+    bne fill
+
+    stz count
+    ldx #0
+next_i:
+    set8a
+    lda flags,x
+    set16a
+    beq not_prime
+
+    ; prime = i + i + 3, then strike out every multiple from i + prime.
+    txa
+    asl a
+    clc
+    adc #3
+    sta prime
+    txy
+    txa
+    clc
+    adc prime
+strike:
+    cmp #SIZE + 1
+    bcs struck
+    tax
+    set8a
+    stz flags,x
+    set16a
+    txa
+    clc
+    adc prime
+    bra strike
+struck:
+    tyx
+    inc count
+
+not_prime:
+    inx
+    cpx #SIZE + 1
+    bne next_i
+
+    dec pass
+    bne next_pass
+
+    lda count
+    stp
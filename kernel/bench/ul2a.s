@@ -0,0 +1,51 @@
+; DT65PC guest benchmark: m_ul2a number formatting
+; Copyright (C) 2026 David Terhune
+;
+; Formats 2000 32-bit numbers to decimal with the kernel's m_ul2a,
+; stepping by 65521. The math library expects 8-bit index registers.
+; Result: 0.
+
+.include "common.s"
+
+COUNT = 2000
+
+buffer = $0500
+
+value = b_zero
+count = b_zero + 4
+
+    clc
+    xce
+    set16a
+    lda #$0FFF
+    tcs
+
+    stz value
+    stz value + 2
+    lda #COUNT
+    sta count
+
+next:
+    pea buffer
+    pei (value + 2)
+    pei (value)
+    jsr m_ul2a
+    pla
+    pla
+    pla
+
+    lda value
+    clc
+    adc #65521
+    sta value
+    lda value + 2
+    adc #0
+    sta value + 2
+
+    dec count
+    bne next
+
+    lda #0
+    stp
+
+.include "math.s"
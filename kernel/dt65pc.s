@@ -20,13 +20,7 @@
 ;======================================================================
 
 ; Kernel zero-page storage
-.struct k_zero
-    banks .byte         ; Number of high RAM banks present
-    flags .byte         ; Bit 0 = math ROM0 present
-                        ; bit 1 = math ROM1 present
-    temp  .dword        ; 4-byte temporary accumulator
-    scratch .res 16     ; 16-byte scratchpad
-.endstruct
+.include "zeropage.s"
 
 ; Kernel storage blocks. Each is one page in length.
 k_base = $0400
@@ -1,6 +1,12 @@
 ; DT65PC Math library
 ; Copyright (C) 2023-25 David Terhune
 
+;======================================================================
+; Signature bytes of simulator host services, called through WDM. On
+; real hardware WDM is a two-byte no-op.
+;======================================================================
+HOST_UL2A = $03
+
 ;======================================================================
 ; Convert binary bytes in scratch to zero-terminated ASCII in a buffer.
 ; The number is in the scratch buffer and the buffer address is in
@@ -50,6 +56,12 @@ next_byte:
     php
     set16a
 
+    ; A simulator may do the whole conversion on the host, clearing
+    ; carry. Without it WDM does nothing and carry stays set.
+    sec
+    .byte $42, HOST_UL2A
+    bcc done
+
     ; Copy input to temp and convert to BCD in scratch.
     lda 4,S
     sta k_zero::temp
@@ -64,6 +76,7 @@ next_byte:
     jsr m_b2a
 
     ; Restore saved processor status and return
+done:
     plp
     rts
 .endproc
@@ -0,0 +1,12 @@
+; DT65PC kernel zero-page layout
+; Copyright (C) 2019-2026 David Terhune
+;
+; Shared by the kernel and programs that link library code from it.
+
+.struct k_zero
+    banks .byte         ; Number of high RAM banks present
+    flags .byte         ; Bit 0 = math ROM0 present
+                        ; bit 1 = math ROM1 present
+    temp  .dword        ; 4-byte temporary accumulator
+    scratch .res 16     ; 16-byte scratchpad
+.endstruct
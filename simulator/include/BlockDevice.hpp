@@ -0,0 +1,131 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef BLOCK_DEVICE_HPP_INCLUDED
+#define BLOCK_DEVICE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "SystemBus.hpp"
+#include "SystemBusDevice.hpp"
+
+// Bytes per sector.
+#define DISK_SECTOR_SIZE    512
+
+// Register offsets from the base address.
+#define DISK_LBA            0x000   ///< sector number, 32 bits
+#define DISK_COMMAND        0x004   ///< DISK_SELECT or DISK_FLUSH on write
+#define DISK_STATUS         0x005   ///< DISK_* status bits
+#define DISK_SECTORS        0x008   ///< sectors in the image, 32 bits
+#define DISK_WINDOW         0x200   ///< the selected sector
+
+// Commands.
+#define DISK_SELECT         0x01    ///< show sector LBA in the window
+#define DISK_FLUSH          0x02    ///< write changed sectors back to the image now
+
+// Status bits.
+#define DISK_READY          0x01    ///< an image is attached
+#define DISK_WRITE_PROTECT  0x02    ///< the image is read-only
+#define DISK_ERROR          0x40    ///< the last LBA selected is past the end
+
+/// @brief Block storage backed by a memory-mapped host disk image.
+/// @details
+/// Occupies 1K: registers at the base and, at DISK_WINDOW, a 512-byte
+/// window onto the sector selected with DISK_SELECT. The window is the
+/// image's own mapping, handed to the bus as page pointers, so the CPU
+/// and the DMA controller read and write sectors at memory speed with no
+/// copying. Place it on a page boundary to get that; otherwise the
+/// window goes through the device a byte at a time.
+///
+/// Changed sectors are written back to the image with msync in batches:
+/// every FLUSH_CYCLES cycles, on DISK_FLUSH and when the device goes
+/// away. Checkpoints save the selected sector, and sector contents
+/// changed through the window are put back with the rest of memory.
+/// Every sector selected while the image is writable is counted
+/// as changed, since writes through the window bypass the device.
+class BlockDevice : public SystemBusDevice {
+public:
+    /// @brief Constructor.
+    /// @param baseAddr base address of the registers
+    /// @param bus bus the device is registered with, for remapping the
+    /// window
+    BlockDevice(const Address &baseAddr, SystemBus &bus);
+    ~BlockDevice();
+
+    /// @brief Map a disk image, read-only if it cannot be written.
+    /// @param filename image file; a partial last sector is ignored
+    /// @param error set to the reason when the image cannot be used
+    /// @return false if the image cannot be mapped
+    bool attach(const std::string &filename, std::string &error);
+
+    void storeByte(const Address &addr, uint8_t val);
+    uint8_t readByte(const Address &addr);
+    bool decodeAddress(const Address &in, Address &out);
+    bool getAddressRange(uint32_t &first, uint32_t &size);
+    void addCycles(int cycles);
+    uint8_t *getPagePointer(const Address &addr, bool write);
+    void saveState(DeviceState &state);
+    void restoreState(DeviceState &state);
+    void addMetrics(MetricsGroup &group);
+
+    /// @brief Write changed sectors back to the image.
+    /// @param wait true to wait for the writes to finish
+    void flush(bool wait);
+
+private:
+    // Base address.
+    uint32_t mBase;
+
+    // Bus to remap the window on.
+    SystemBus &mBus;
+
+    // Mapped image.
+    uint8_t *mImage;
+    size_t mImageSize;
+    uint32_t mSectors;
+    bool mWritable;
+
+    // Registers.
+    uint32_t mLba;
+    uint8_t mStatus;
+
+    // Sector in the window, or null.
+    uint8_t *mWindow;
+
+    // Range of sectors changed since the last flush.
+    uint32_t mDirtyFirst;
+    uint32_t mDirtyLast;
+    bool mDirty;
+
+    // Cycles until the next batched flush.
+    int mCyclesUntilFlush;
+
+    // Disallow copy construction and assignment.
+    BlockDevice(const BlockDevice &);
+    BlockDevice &operator=(const BlockDevice &);
+
+    // Show sector mLba in the window.
+    void select();
+    // Note a sector that may change.
+    void markDirty(uint32_t sector);
+    // Unmap the image.
+    void detach();
+};
+
+#endif // BLOCK_DEVICE_HPP_INCLUDED
@@ -0,0 +1,100 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef BREAKPOINTS_HPP_INCLUDED
+#define BREAKPOINTS_HPP_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "SystemBusDevice.hpp"
+
+/// @brief Set of execution breakpoints over the 24-bit address space.
+/// @details
+/// Breakpoints are kept in a bitmap that is only allocated for pages that
+/// hold at least one breakpoint. Checking an address is a page table load
+/// and, for pages with breakpoints, a single bit test.
+class BreakpointSet {
+public:
+    BreakpointSet();
+
+    /// @brief Add a breakpoint, replacing any already at the address.
+    /// @param addr breakpoint address
+    /// @param temporary remove the breakpoint the first time it stops
+    /// @param ignoreCount number of hits to pass over before stopping
+    void add(const Address &addr, bool temporary = false, uint32_t ignoreCount = 0);
+
+    /// @brief Remove a breakpoint.
+    /// @param addr breakpoint address
+    /// @return false if there was no breakpoint at the address
+    bool remove(const Address &addr);
+
+    /// @brief Remove all breakpoints.
+    void clear();
+
+    /// @brief Check for no breakpoints at all.
+    bool empty() const { return mBreakpoints.empty(); }
+
+    /// @brief Check if a breakpoint is set at an address.
+    /// @param addr 24-bit address
+    bool isSet(uint32_t addr) const {
+        const uint64_t *bits = mPages[(addr >> 8) & 0xFFFF];
+        return bits && ((bits[(addr >> 6) & 3] >> (addr & 63)) & 1);
+    }
+
+    /// @brief Check if any breakpoint is set in an address range.
+    /// @details
+    /// Lets block-based execution split blocks at breakpoints without
+    /// testing every address.
+    /// @param first first 24-bit address
+    /// @param last last 24-bit address, inclusive
+    bool anyInRange(uint32_t first, uint32_t last) const;
+
+    /// @brief Record a hit at an address where isSet() is true.
+    /// @details
+    /// Updates the hit count and removes temporary breakpoints that stop.
+    /// @param addr 24-bit address
+    /// @return true if execution should stop
+    bool hit(uint32_t addr);
+
+    /// @brief Number of times a breakpoint has been reached.
+    /// @param addr breakpoint address
+    uint32_t hitCount(const Address &addr) const;
+
+private:
+    struct Breakpoint {
+        bool temporary;
+        uint32_t ignoreCount;
+        uint32_t hits;
+    };
+
+    // Per-page bitmaps of 256 bits, null for pages without breakpoints.
+    std::vector<uint64_t *> mPages;
+
+    // Owned bitmap storage, indexed by page.
+    std::map<uint16_t, std::unique_ptr<uint64_t[]>> mPageBits;
+
+    // Breakpoint details, indexed by 24-bit address.
+    std::map<uint32_t, Breakpoint> mBreakpoints;
+
+    void setBit(uint32_t addr);
+    void clearBit(uint32_t addr);
+};
+
+#endif // BREAKPOINTS_HPP_INCLUDED
@@ -0,0 +1,107 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef CALLGRAPH_HPP_INCLUDED
+#define CALLGRAPH_HPP_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "Symbols.hpp"
+
+/// @brief Call-graph profile built from a shadow call stack.
+/// @details
+/// The CPU reports subroutine calls and interrupt entries, and returns
+/// from them, together with the stack pointer after the instruction.
+/// Frames are matched by stack pointer rather than counted: a return pops
+/// every frame entered at a lower stack pointer. Argument passing with
+/// pea/pla, RTS used as a computed jump and a stack pointer reloaded with
+/// TCS/TXS therefore leave the shadow stack consistent with the real one.
+///
+/// Cycles are charged to the frame on top of the shadow stack when it
+/// changes, so nothing is done between calls.
+class CallGraph {
+public:
+    CallGraph();
+
+    /// @brief Start a new shadow stack.
+    /// @param addr 24-bit address execution starts at, the root routine
+    /// @param cycles current CPU cycle count
+    void start(uint32_t addr, uint64_t cycles);
+
+    /// @brief Enter a subroutine or interrupt handler.
+    /// @param addr 24-bit address of the routine
+    /// @param stackPointer stack pointer after the return address was pushed
+    /// @param cycles current CPU cycle count
+    void enter(uint32_t addr, uint16_t stackPointer, uint64_t cycles);
+
+    /// @brief Return from a subroutine or interrupt handler.
+    /// @param stackPointer stack pointer after the return address was pulled
+    /// @param cycles current CPU cycle count
+    void leave(uint16_t stackPointer, uint64_t cycles);
+
+    /// @brief Charge cycles up to now to the current routine.
+    /// @param cycles current CPU cycle count
+    void update(uint64_t cycles);
+
+    /// @brief Current call depth; the root routine is depth one.
+    size_t depth() const { return mFrames.size(); }
+
+    /// @brief Address of a routine on the shadow stack.
+    /// @param level 0 for the current routine, 1 for its caller, and so on
+    uint32_t routineAt(size_t level) const { return mNodes[mFrames[mFrames.size() - 1 - level].node].address; }
+
+    /// @brief Write exclusive cycles per call path in collapsed-stack
+    /// form ("outer;inner cycles" lines) for flame-graph tools.
+    /// @param out stream to write to
+    /// @param symbols symbols used to name routines
+    void writeCollapsed(std::ostream &out, const Symbols &symbols) const;
+
+    /// @brief Write inclusive and exclusive cycles per routine.
+    /// @param out stream to write to
+    /// @param symbols symbols used to name routines
+    /// @param limit maximum number of routines listed
+    void report(std::ostream &out, const Symbols &symbols, size_t limit = 50) const;
+
+private:
+    // One distinct call path.
+    struct Node {
+        uint32_t address;
+        uint32_t parent;
+        uint64_t cycles;
+        uint64_t calls;
+    };
+
+    struct Frame {
+        uint32_t node;
+        // Stack pointer after entry; above any 16-bit value for the root.
+        uint32_t stackPointer;
+    };
+
+    std::vector<Node> mNodes;
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> mChildren;
+    std::vector<Frame> mFrames;
+    uint64_t mLastCycles;
+
+    uint32_t child(uint32_t parent, uint32_t addr);
+    std::string path(uint32_t node, const Symbols &symbols) const;
+};
+
+#endif // CALLGRAPH_HPP_INCLUDED
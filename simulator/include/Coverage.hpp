@@ -0,0 +1,70 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef COVERAGE_HPP_INCLUDED
+#define COVERAGE_HPP_INCLUDED
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// @brief Executed-address coverage over the 24-bit address space.
+/// @details
+/// One bit per address, set for the opcode byte of every instruction
+/// fetched. The whole map is 2 MiB, so marking is a single OR with no
+/// allocation or branch. Saved maps hold only the pages with bits set and
+/// merge by bitwise OR.
+class Coverage {
+public:
+    Coverage();
+
+    /// @brief Record an instruction fetch.
+    /// @param addr 24-bit address of the opcode
+    void mark(uint32_t addr) { mBits[(addr >> 6) & 0x3FFFF] |= (uint64_t)1 << (addr & 63); }
+
+    /// @brief Check whether an instruction at an address was executed.
+    /// @param addr 24-bit address
+    bool covered(uint32_t addr) const { return (mBits[(addr >> 6) & 0x3FFFF] >> (addr & 63)) & 1; }
+
+    /// @brief OR another coverage map into this one.
+    void merge(const Coverage &other);
+
+    /// @brief OR a saved coverage map into this one.
+    /// @param filename file written by save
+    /// @return false if the file could not be read or is not a coverage map
+    bool load(const std::string &filename);
+
+    /// @brief Save the coverage map.
+    /// @param filename file to write
+    /// @return false if the file could not be written
+    bool save(const std::string &filename) const;
+
+    /// @brief Write a ca65 listing annotated with coverage.
+    /// @details
+    /// Code lines are marked '+' when executed and '-' when not. A summary
+    /// per label lists the lines never executed.
+    /// @param out stream to write to
+    /// @param listing ca65 listing file (-l)
+    /// @return false if the listing could not be read
+    bool report(std::ostream &out, const std::string &listing) const;
+
+private:
+    std::vector<uint64_t> mBits;
+};
+
+#endif // COVERAGE_HPP_INCLUDED
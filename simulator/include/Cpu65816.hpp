@@ -32,6 +32,10 @@
 #include "Log.hpp"
 #include "Binary.hpp"
 #include "BuildConfig.hpp"
+#include "CallGraph.hpp"
+#include "Coverage.hpp"
+#include "Profiler.hpp"
+#include "Sampler.hpp"
 
 // Interrupt Vector Addresses
 #define NCOP    0xFFE4
@@ -48,11 +52,28 @@
 // Macro used by OpCode methods when an unrecognized OpCode is being executed.
 #define LOG_UNEXPECTED_OPCODE(opCode) Log::err(LOG_TAG).str("Unexpected OpCode: ").str(opCode.getName()).show();
 
+class Cpu65816Bench;
 class Cpu65816Debugger;
+class HostServices;
 
 class Cpu65816 {
+        friend class Cpu65816Bench;
         friend class Cpu65816Debugger;
     public:
+        // Programmer-visible registers
+        struct Registers {
+            uint16_t a;
+            uint16_t x;
+            uint16_t y;
+            uint16_t s;
+            uint16_t d;
+            uint16_t pc;
+            uint8_t p;
+            uint8_t dbr;
+            uint8_t pbr;
+            bool e;
+        };
+
         Cpu65816(SystemBus &);
 
         void setRESPin(bool);
@@ -75,6 +96,38 @@ class Cpu65816 {
         void setProgramAddress(const Address &);
         Stack *getStack();
         CpuStatus *getCpuStatus();
+        uint64_t getTotalCycles() const { return mTotalCyclesCounter; }
+        uint64_t getTotalInstructions() const { return mInstructionCounter; }
+        uint64_t getInterruptsTaken() const { return mInterruptCounter; }
+        uint64_t getWaits() const { return mWaitCounter; }
+        // STP holds the reset line, so this is true from STP until the next reset
+        bool isStopped() const { return mPins.RES; }
+
+        // Read or replace the whole register state at once
+        Registers getRegisters();
+        void setRegisters(const Registers &);
+
+        // Everything needed to resume from a point: the registers, the
+        // reset line and the counters
+        struct Snapshot {
+            Registers registers;
+            bool stopped;
+            uint64_t cycles;
+            uint64_t instructions;
+        };
+        Snapshot getSnapshot();
+        void restoreSnapshot(const Snapshot &);
+
+        // Count each executed instruction in a profiler; null to stop
+        void setProfiler(Profiler *profiler) { mProfiler = profiler; }
+        // Track calls and returns in a call graph; null to stop
+        void setCallGraph(CallGraph *);
+        // Mark each executed instruction in a coverage map; null to stop
+        void setCoverage(Coverage *coverage) { mCoverage = coverage; }
+        // Sample the program counter every so many cycles; null to stop
+        void setSampler(Sampler *);
+        // Call host services through WDM; null to make WDM a no-op again
+        void setHostServices(HostServices *services) { mHostServices = services; }
 
     private:
         SystemBus &mSystemBus;
@@ -114,6 +167,23 @@ class Cpu65816 {
 
         // Total number of cycles
         uint64_t mTotalCyclesCounter = 0;
+        // Total number of instructions fetched
+        uint64_t mInstructionCounter = 0;
+        // Interrupts taken and WAI instructions executed, for metrics
+        uint64_t mInterruptCounter = 0;
+        uint64_t mWaitCounter = 0;
+
+        // Execution profile, if one is being taken
+        Profiler *mProfiler = nullptr;
+        // Call graph, if one is being taken
+        CallGraph *mCallGraph = nullptr;
+        // Coverage map, if coverage is being taken
+        Coverage *mCoverage = nullptr;
+        // Sampling profiler and the cycle count of its next sample
+        Sampler *mSampler = nullptr;
+        uint64_t mSampleDeadline = UINT64_MAX;
+        // Services WDM can call, if any
+        HostServices *mHostServices = nullptr;
 
         bool accumulatorIs8BitWide();
         bool accumulatorIs16BitWide();
@@ -123,11 +193,43 @@ class Cpu65816 {
         uint16_t indexWithXRegister();
         uint16_t indexWithYRegister();
 
-        Address getAddressOfOpCodeData(OpCode &);
-        bool opCodeAddressingCrossesPageBoundary(OpCode &);
+        // Operand of the current instruction. It is resolved on first use
+        // and kept until the next instruction, so the operand bytes and any
+        // pointer they lead to are read from the bus once.
+        struct Operand {
+            // Effective address of the data
+            Address address;
+            // Indexing moved the address onto another page, which costs a
+            // cycle for the modes that check it
+            bool crossesPage;
+            bool resolved;
+        };
+        Operand mOperand {};
+
+        void resolveOperand(OpCode &);
+
+        Address getAddressOfOpCodeData(OpCode &opCode) {
+            if (!mOperand.resolved) resolveOperand(opCode);
+            return mOperand.address;
+        }
+        bool opCodeAddressingCrossesPageBoundary(OpCode &opCode) {
+            if (!mOperand.resolved) resolveOperand(opCode);
+            return mOperand.crossesPage;
+        }
 
         void addToCycles(int);
         void subtractFromCycles(int);
+
+        // Report a call or interrupt entry that has just completed
+        void traceCall() {
+            if (mCallGraph) mCallGraph->enter(mProgramAddress.getAbsolute(), mStack.getStackPointer(), mTotalCyclesCounter);
+            if (mSampler) mSampler->enter(mProgramAddress.getAbsolute(), mStack.getStackPointer());
+        }
+        // Report a return that has just completed
+        void traceReturn() {
+            if (mCallGraph) mCallGraph->leave(mStack.getStackPointer(), mTotalCyclesCounter);
+            if (mSampler) mSampler->leave(mStack.getStackPointer());
+        }
         void addToProgramAddress(int);
         void addToProgramAddressAndCycles(int, int);
 
@@ -23,19 +23,59 @@
 #include <cstdint>
 #include <functional>
 
+#include "Breakpoints.hpp"
 #include "SystemBusDevice.hpp"
 #include "BuildConfig.hpp"
 #include "Cpu65816.hpp"
+#include "Machine.hpp"
+
+/// @brief Debugger hook policy that does nothing.
+/// @details
+/// Policies supply the four hooks and say whether each instruction is
+/// traced. runUntil with this one compiles down to the interpreter loop
+/// plus the breakpoint and watchpoint checks.
+struct NoHooks {
+    static constexpr bool TRACE = false;
+    void beforeStep() {}
+    void afterStep() {}
+    void breakPoint() {}
+    void stp() {}
+};
+
+/// @brief Hook policy that only writes each instruction to the trace log.
+struct TraceHooks : NoHooks {
+    static constexpr bool TRACE = true;
+};
 
 class Cpu65816Debugger {
     public:
         Cpu65816Debugger(Cpu65816 &);
+        // Share a breakpoint set, such as the machine's, instead of
+        // keeping one of its own
+        Cpu65816Debugger(Cpu65816 &, BreakpointSet &);
 
         void step();
+
+        // Step until a breakpoint, watchpoint, STP or the cycle budget,
+        // calling the policy's hooks rather than the handlers below
+        template <typename Hooks>
+        StopReason runUntil(Hooks &hooks, uint64_t maxCycles = UINT64_MAX) {
+            if (mBreakpointHit) return StopReason::Breakpoint;
+            const uint64_t start = mCpu.mTotalCyclesCounter;
+            const uint64_t limit = maxCycles > UINT64_MAX - start ? UINT64_MAX : start + maxCycles;
+            StopReason reason = StopReason::CycleBudget;
+            while (mCpu.mTotalCyclesCounter < limit && !stepWith(hooks, reason)) {
+            }
+            return reason;
+        }
+
         void setBreakPoint(const Address &);
+        BreakpointSet &breakPoints();
+        void resume();
         void dumpCpu() const ;
         void logStatusRegister() const ;
         void logOpCode(OpCode &) const ;
+        void logWatchHit(const Watchpoints::Hit &, const Address &) const ;
 
         void doBeforeStep(std::function<void ()>);
         void doAfterStep(std::function<void ()>);
@@ -43,16 +83,67 @@ class Cpu65816Debugger {
         void onStp(std::function<void ()>);
 
     private:
+        // Policy calling the handlers set with doBeforeStep and the rest.
+        struct FunctionHooks {
+            static constexpr bool TRACE = true;
+            Cpu65816Debugger &debugger;
+            void beforeStep() { if (debugger.mOnBeforeStepHandler) debugger.mOnBeforeStepHandler(); }
+            void afterStep() { if (debugger.mOnAfterStepHandler) debugger.mOnAfterStepHandler(); }
+            void breakPoint() { if (debugger.mOnBreakPointHandler) debugger.mOnBreakPointHandler(); }
+            void stp() { if (debugger.mOnStpHandler) debugger.mOnStpHandler(); }
+        };
+
         std::function<void ()> mOnBeforeStepHandler;
         std::function<void ()> mOnAfterStepHandler;
         std::function<void ()> mOnBreakPointHandler;
         std::function<void ()> mOnStpHandler;
 
-        // Let's assume $00:$0000 is not a valid address for code
-        Address mBreakPointAddress {0x00, 0x0000};
+        BreakpointSet mOwnBreakPoints;
+        BreakpointSet &mBreakPoints;
         bool mBreakpointHit = false;
 
         Cpu65816 &mCpu;
+
+        // Execute one instruction; true if execution should stop.
+        template <typename Hooks>
+        bool stepWith(Hooks &hooks, StopReason &reason) {
+            hooks.beforeStep();
+            const Address instructionAddress = mCpu.mProgramAddress;
+            if (Hooks::TRACE) logNextOpCode();
+
+            const bool executed = mCpu.executeNextInstruction();
+            if (mCpu.isStopped()) {
+                reason = StopReason::Stp;
+                hooks.stp();
+                return true;
+            }
+            if (!executed) {
+                reason = StopReason::Unimplemented;
+                return true;
+            }
+            hooks.afterStep();
+
+            const uint32_t programAddress = mCpu.mProgramAddress.getAbsolute();
+            if (mBreakPoints.isSet(programAddress) && mBreakPoints.hit(programAddress)) {
+                mBreakpointHit = true;
+                logBreakPoint();
+                reason = StopReason::Breakpoint;
+                hooks.breakPoint();
+                return true;
+            }
+            if (mCpu.mSystemBus.watchpoints().hasHits()) {
+                logWatchHits(instructionAddress);
+                mBreakpointHit = true;
+                reason = StopReason::Watchpoint;
+                hooks.breakPoint();
+                return true;
+            }
+            return false;
+        }
+
+        void logNextOpCode() const;
+        void logBreakPoint() const;
+        void logWatchHits(const Address &);
 };
 
 #endif // CPU65816DEBUGGER_H
@@ -0,0 +1,64 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DEVICE_STATE_HPP_INCLUDED
+#define DEVICE_STATE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/// @brief Saved registers of one device, for checkpoints.
+/// @details
+/// Values are written with put and read back with get in the same
+/// order. Only trivially copyable values can be stored; containers are
+/// stored as a count followed by their elements.
+class DeviceState {
+public:
+    template <typename T>
+    void put(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "DeviceState holds plain values");
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+        mBytes.insert(mBytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "DeviceState holds plain values");
+        T value;
+        if (mRead + sizeof(T) > mBytes.size()) {
+            memset(&value, 0, sizeof(T));
+            return value;
+        }
+        memcpy(&value, mBytes.data() + mRead, sizeof(T));
+        mRead += sizeof(T);
+        return value;
+    }
+
+    /// @brief Start reading from the beginning again.
+    void rewind() { mRead = 0; }
+
+    bool empty() const { return mBytes.empty(); }
+
+private:
+    std::vector<uint8_t> mBytes;
+    size_t mRead = 0;
+};
+
+#endif // DEVICE_STATE_HPP_INCLUDED
@@ -0,0 +1,368 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DISASSEMBLER_HPP_INCLUDED
+#define DISASSEMBLER_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "Addressing.hpp"
+
+/// @brief Register width that controls the size of an immediate operand.
+enum class OperandWidth : uint8_t {
+    Fixed,  ///< operand size never changes
+    M,      ///< one extra byte when the accumulator is 16 bits wide
+    X       ///< one extra byte when the index registers are 16 bits wide
+};
+
+/// @brief Static decoding information for one opcode.
+struct OpCodeInfo {
+    const char *mnemonic;
+    AddressingMode mode;
+    uint8_t operandSize;    ///< operand bytes with 8-bit registers
+    OperandWidth width;
+};
+
+/// @brief One decoded instruction.
+struct DecodedInstruction {
+    uint32_t address;           ///< 24-bit address of the opcode
+    uint8_t bytes[4];           ///< opcode followed by operand bytes
+    uint8_t length;             ///< total instruction length in bytes
+    const OpCodeInfo *info;
+
+    /// @brief Operand bytes as a little-endian value.
+    uint32_t operand() const {
+        return bytes[1] | ((uint32_t)bytes[2] << 8) | ((uint32_t)bytes[3] << 16);
+    }
+};
+
+/// @brief Table-driven 65816 disassembler.
+/// @details
+/// Decoding works on plain byte buffers and never touches the system bus,
+/// so the same code serves the debugger trace, the profiler reports and
+/// bulk disassembly of ROM images.
+class Disassembler {
+public:
+    /// @brief Size of a buffer large enough for any formatted instruction.
+    static const size_t MAX_TEXT_LENGTH = 32;
+
+    /// @brief Decoding information indexed by opcode.
+    static constexpr OpCodeInfo OP_CODE_INFO[256] = {
+    { "BRK", AddressingMode::Interrupt,                          1, OperandWidth::Fixed }, // 00
+    { "ORA", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // 01
+    { "COP", AddressingMode::Interrupt,                          1, OperandWidth::Fixed }, // 02
+    { "ORA", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // 03
+    { "TSB", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 04
+    { "ORA", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 05
+    { "ASL", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 06
+    { "ORA", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // 07
+    { "PHP", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 08
+    { "ORA", AddressingMode::Immediate,                          1, OperandWidth::M }, // 09
+    { "ASL", AddressingMode::Accumulator,                        0, OperandWidth::Fixed }, // 0A
+    { "PHD", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 0B
+    { "TSB", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 0C
+    { "ORA", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 0D
+    { "ASL", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 0E
+    { "ORA", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // 0F
+    { "BPL", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // 10
+    { "ORA", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // 11
+    { "ORA", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // 12
+    { "ORA", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // 13
+    { "TRB", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 14
+    { "ORA", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 15
+    { "ASL", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 16
+    { "ORA", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // 17
+    { "CLC", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 18
+    { "ORA", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // 19
+    { "INC", AddressingMode::Accumulator,                        0, OperandWidth::Fixed }, // 1A
+    { "TCS", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 1B
+    { "TRB", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 1C
+    { "ORA", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 1D
+    { "ASL", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 1E
+    { "ORA", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // 1F
+    { "JSR", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 20
+    { "AND", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // 21
+    { "JSL", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // 22
+    { "AND", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // 23
+    { "BIT", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 24
+    { "AND", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 25
+    { "ROL", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 26
+    { "AND", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // 27
+    { "PLP", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 28
+    { "AND", AddressingMode::Immediate,                          1, OperandWidth::M }, // 29
+    { "ROL", AddressingMode::Accumulator,                        0, OperandWidth::Fixed }, // 2A
+    { "PLD", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 2B
+    { "BIT", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 2C
+    { "AND", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 2D
+    { "ROL", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 2E
+    { "AND", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // 2F
+    { "BMI", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // 30
+    { "AND", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // 31
+    { "AND", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // 32
+    { "AND", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // 33
+    { "BIT", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 34
+    { "AND", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 35
+    { "ROL", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 36
+    { "AND", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // 37
+    { "SEC", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 38
+    { "AND", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // 39
+    { "DEC", AddressingMode::Accumulator,                        0, OperandWidth::Fixed }, // 3A
+    { "TSC", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 3B
+    { "BIT", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 3C
+    { "AND", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 3D
+    { "ROL", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 3E
+    { "AND", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // 3F
+    { "RTI", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 40
+    { "EOR", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // 41
+    { "WDM", AddressingMode::Immediate,                          1, OperandWidth::Fixed }, // 42
+    { "EOR", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // 43
+    { "MVP", AddressingMode::BlockMove,                          2, OperandWidth::Fixed }, // 44
+    { "EOR", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 45
+    { "LSR", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 46
+    { "EOR", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // 47
+    { "PHA", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 48
+    { "EOR", AddressingMode::Immediate,                          1, OperandWidth::M }, // 49
+    { "LSR", AddressingMode::Accumulator,                        0, OperandWidth::Fixed }, // 4A
+    { "PHK", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 4B
+    { "JMP", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 4C
+    { "EOR", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 4D
+    { "LSR", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 4E
+    { "EOR", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // 4F
+    { "BVC", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // 50
+    { "EOR", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // 51
+    { "EOR", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // 52
+    { "EOR", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // 53
+    { "MVN", AddressingMode::BlockMove,                          2, OperandWidth::Fixed }, // 54
+    { "EOR", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 55
+    { "LSR", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 56
+    { "EOR", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // 57
+    { "CLI", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 58
+    { "EOR", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // 59
+    { "PHY", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 5A
+    { "TCD", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 5B
+    { "JML", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // 5C
+    { "EOR", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 5D
+    { "LSR", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 5E
+    { "EOR", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // 5F
+    { "RTS", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 60
+    { "ADC", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // 61
+    { "PER", AddressingMode::StackProgramCounterRelativeLong,    2, OperandWidth::Fixed }, // 62
+    { "ADC", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // 63
+    { "STZ", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 64
+    { "ADC", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 65
+    { "ROR", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 66
+    { "ADC", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // 67
+    { "PLA", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 68
+    { "ADC", AddressingMode::Immediate,                          1, OperandWidth::M }, // 69
+    { "ROR", AddressingMode::Accumulator,                        0, OperandWidth::Fixed }, // 6A
+    { "RTL", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 6B
+    { "JMP", AddressingMode::AbsoluteIndirect,                   2, OperandWidth::Fixed }, // 6C
+    { "ADC", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 6D
+    { "ROR", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 6E
+    { "ADC", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // 6F
+    { "BVS", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // 70
+    { "ADC", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // 71
+    { "ADC", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // 72
+    { "ADC", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // 73
+    { "STZ", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 74
+    { "ADC", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 75
+    { "ROR", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 76
+    { "ADC", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // 77
+    { "SEI", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 78
+    { "ADC", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // 79
+    { "PLY", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 7A
+    { "TDC", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 7B
+    { "JMP", AddressingMode::AbsoluteIndexedIndirectWithX,       2, OperandWidth::Fixed }, // 7C
+    { "ADC", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 7D
+    { "ROR", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 7E
+    { "ADC", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // 7F
+    { "BRA", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // 80
+    { "STA", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // 81
+    { "BRL", AddressingMode::ProgramCounterRelativeLong,         2, OperandWidth::Fixed }, // 82
+    { "STA", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // 83
+    { "STY", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 84
+    { "STA", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 85
+    { "STX", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // 86
+    { "STA", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // 87
+    { "DEY", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 88
+    { "BIT", AddressingMode::Immediate,                          1, OperandWidth::M }, // 89
+    { "TXA", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 8A
+    { "PHB", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // 8B
+    { "STY", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 8C
+    { "STA", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 8D
+    { "STX", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 8E
+    { "STA", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // 8F
+    { "BCC", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // 90
+    { "STA", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // 91
+    { "STA", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // 92
+    { "STA", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // 93
+    { "STY", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 94
+    { "STA", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // 95
+    { "STX", AddressingMode::DirectPageIndexedWithY,             1, OperandWidth::Fixed }, // 96
+    { "STA", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // 97
+    { "TYA", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 98
+    { "STA", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // 99
+    { "TXS", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 9A
+    { "TXY", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // 9B
+    { "STZ", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // 9C
+    { "STA", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 9D
+    { "STZ", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // 9E
+    { "STA", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // 9F
+    { "LDY", AddressingMode::Immediate,                          1, OperandWidth::X }, // A0
+    { "LDA", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // A1
+    { "LDX", AddressingMode::Immediate,                          1, OperandWidth::X }, // A2
+    { "LDA", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // A3
+    { "LDY", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // A4
+    { "LDA", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // A5
+    { "LDX", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // A6
+    { "LDA", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // A7
+    { "TAY", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // A8
+    { "LDA", AddressingMode::Immediate,                          1, OperandWidth::M }, // A9
+    { "TAX", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // AA
+    { "PLB", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // AB
+    { "LDY", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // AC
+    { "LDA", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // AD
+    { "LDX", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // AE
+    { "LDA", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // AF
+    { "BCS", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // B0
+    { "LDA", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // B1
+    { "LDA", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // B2
+    { "LDA", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // B3
+    { "LDY", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // B4
+    { "LDA", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // B5
+    { "LDX", AddressingMode::DirectPageIndexedWithY,             1, OperandWidth::Fixed }, // B6
+    { "LDA", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // B7
+    { "CLV", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // B8
+    { "LDA", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // B9
+    { "TSX", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // BA
+    { "TYX", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // BB
+    { "LDY", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // BC
+    { "LDA", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // BD
+    { "LDX", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // BE
+    { "LDA", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // BF
+    { "CPY", AddressingMode::Immediate,                          1, OperandWidth::X }, // C0
+    { "CMP", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // C1
+    { "REP", AddressingMode::Immediate,                          1, OperandWidth::Fixed }, // C2
+    { "CMP", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // C3
+    { "CPY", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // C4
+    { "CMP", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // C5
+    { "DEC", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // C6
+    { "CMP", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // C7
+    { "INY", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // C8
+    { "CMP", AddressingMode::Immediate,                          1, OperandWidth::M }, // C9
+    { "DEX", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // CA
+    { "WAI", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // CB
+    { "CPY", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // CC
+    { "CMP", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // CD
+    { "DEC", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // CE
+    { "CMP", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // CF
+    { "BNE", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // D0
+    { "CMP", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // D1
+    { "CMP", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // D2
+    { "CMP", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // D3
+    { "PEI", AddressingMode::StackDirectPageIndirect,            1, OperandWidth::Fixed }, // D4
+    { "CMP", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // D5
+    { "DEC", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // D6
+    { "CMP", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // D7
+    { "CLD", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // D8
+    { "CMP", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // D9
+    { "PHX", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // DA
+    { "STP", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // DB
+    { "JML", AddressingMode::AbsoluteIndirectLong,               2, OperandWidth::Fixed }, // DC
+    { "CMP", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // DD
+    { "DEC", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // DE
+    { "CMP", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // DF
+    { "CPX", AddressingMode::Immediate,                          1, OperandWidth::X }, // E0
+    { "SBC", AddressingMode::DirectPageIndexedIndirectWithX,     1, OperandWidth::Fixed }, // E1
+    { "SEP", AddressingMode::Immediate,                          1, OperandWidth::Fixed }, // E2
+    { "SBC", AddressingMode::StackRelative,                      1, OperandWidth::Fixed }, // E3
+    { "CPX", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // E4
+    { "SBC", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // E5
+    { "INC", AddressingMode::DirectPage,                         1, OperandWidth::Fixed }, // E6
+    { "SBC", AddressingMode::DirectPageIndirectLong,             1, OperandWidth::Fixed }, // E7
+    { "INX", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // E8
+    { "SBC", AddressingMode::Immediate,                          1, OperandWidth::M }, // E9
+    { "NOP", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // EA
+    { "XBA", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // EB
+    { "CPX", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // EC
+    { "SBC", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // ED
+    { "INC", AddressingMode::Absolute,                           2, OperandWidth::Fixed }, // EE
+    { "SBC", AddressingMode::AbsoluteLong,                       3, OperandWidth::Fixed }, // EF
+    { "BEQ", AddressingMode::ProgramCounterRelative,             1, OperandWidth::Fixed }, // F0
+    { "SBC", AddressingMode::DirectPageIndirectIndexedWithY,     1, OperandWidth::Fixed }, // F1
+    { "SBC", AddressingMode::DirectPageIndirect,                 1, OperandWidth::Fixed }, // F2
+    { "SBC", AddressingMode::StackRelativeIndirectIndexedWithY,  1, OperandWidth::Fixed }, // F3
+    { "PEA", AddressingMode::StackAbsolute,                      2, OperandWidth::Fixed }, // F4
+    { "SBC", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // F5
+    { "INC", AddressingMode::DirectPageIndexedWithX,             1, OperandWidth::Fixed }, // F6
+    { "SBC", AddressingMode::DirectPageIndirectLongIndexedWithY, 1, OperandWidth::Fixed }, // F7
+    { "SED", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // F8
+    { "SBC", AddressingMode::AbsoluteIndexedWithY,               2, OperandWidth::Fixed }, // F9
+    { "PLX", AddressingMode::StackImplied,                       0, OperandWidth::Fixed }, // FA
+    { "XCE", AddressingMode::Implied,                            0, OperandWidth::Fixed }, // FB
+    { "JSR", AddressingMode::AbsoluteIndexedIndirectWithX,       2, OperandWidth::Fixed }, // FC
+    { "SBC", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // FD
+    { "INC", AddressingMode::AbsoluteIndexedWithX,               2, OperandWidth::Fixed }, // FE
+    { "SBC", AddressingMode::AbsoluteLongIndexedWithX,           3, OperandWidth::Fixed }, // FF
+    };
+
+    /// @brief Length of an instruction, including the opcode.
+    /// @param opcode opcode byte
+    /// @param m8 true if the accumulator is 8 bits wide
+    /// @param x8 true if the index registers are 8 bits wide
+    /// @return instruction length in bytes
+    static constexpr uint8_t instructionLength(uint8_t opcode, bool m8, bool x8) {
+        return 1 + OP_CODE_INFO[opcode].operandSize +
+            ((OP_CODE_INFO[opcode].width == OperandWidth::M && !m8) ||
+             (OP_CODE_INFO[opcode].width == OperandWidth::X && !x8) ? 1 : 0);
+    }
+
+    /// @brief Decode one instruction from a byte buffer.
+    /// @param bytes instruction bytes, starting with the opcode
+    /// @param size number of bytes available in the buffer
+    /// @param address 24-bit address of the opcode
+    /// @param m8 true if the accumulator is 8 bits wide
+    /// @param x8 true if the index registers are 8 bits wide
+    /// @param out decoded instruction
+    /// @return false if the buffer ends before the instruction does
+    static bool decode(const uint8_t *bytes, size_t size, uint32_t address,
+                       bool m8, bool x8, DecodedInstruction &out);
+
+    /// @brief Format the mnemonic and operand of an instruction.
+    /// @param in decoded instruction
+    /// @param out buffer of at least MAX_TEXT_LENGTH characters
+    /// @return number of characters written, excluding the terminator
+    static size_t format(const DecodedInstruction &in, char *out);
+
+    /// @brief Disassemble a whole memory image.
+    /// @details
+    /// REP and SEP instructions are followed to track register widths,
+    /// which is the same assumption the assembler makes.
+    /// @param bytes image contents
+    /// @param size image size in bytes
+    /// @param base 24-bit address of the first byte
+    /// @param m8 initial accumulator width
+    /// @param x8 initial index register width
+    /// @param out stream receiving one line per instruction
+    /// @return number of instructions decoded
+    static size_t disassemble(const uint8_t *bytes, size_t size, uint32_t base,
+                              bool m8, bool x8, std::ostream &out);
+};
+
+#endif // DISASSEMBLER_HPP_INCLUDED
@@ -0,0 +1,110 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DMA_CONTROLLER_HPP_INCLUDED
+#define DMA_CONTROLLER_HPP_INCLUDED
+
+#include "SystemBus.hpp"
+#include "SystemBusDevice.hpp"
+
+// Register offsets from the base address.
+#define DMA_SOURCE      0x00    ///< source address, 24 bits
+#define DMA_DEST        0x03    ///< destination address, 24 bits
+#define DMA_COUNT       0x06    ///< bytes left to move, 24 bits
+#define DMA_CONTROL     0x09    ///< DMA_* control bits
+#define DMA_STATUS      0x0A    ///< DMA_BUSY and DMA_DONE
+
+// Control register bits.
+#define DMA_START       0x01    ///< start the transfer
+#define DMA_SRC_FIXED   0x02    ///< source is a device register (device to memory)
+#define DMA_DST_FIXED   0x04    ///< destination is a device register (memory to device)
+#define DMA_BURST       0x08    ///< stall the CPU for the whole transfer
+#define DMA_IRQ_ENABLE  0x40    ///< interrupt on completion
+
+// Status register bits.
+#define DMA_DONE        0x01    ///< transfer finished; write 1 to acknowledge
+#define DMA_BUSY        0x80    ///< transfer in progress
+
+/// @brief Simulated DMA controller.
+/// @details
+/// Occupies 16 bytes. Moves COUNT bytes from SOURCE to DESTINATION,
+/// incrementing each address unless it is fixed, so one controller
+/// covers memory to memory, memory to device and device to memory. The
+/// address and count registers advance as the transfer proceeds.
+///
+/// A byte takes two bus cycles. By default the controller steals every
+/// other bus cycle, so the CPU keeps running at half speed while the
+/// transfer is in progress; DMA_BURST instead moves everything at once
+/// and stalls the CPU for the whole transfer. Either way stolen cycles
+/// are charged in bulk through SystemBus::stall. Runs of RAM are copied
+/// through the bus's host page pointers; device registers and watched
+/// pages go through the bus a byte at a time. There is no flow control
+/// toward devices, so a transfer to a UART should fit its FIFO.
+///
+/// On completion DMA_DONE is set and, with DMA_IRQ_ENABLE, the IRQ line
+/// is held active until DMA_DONE is acknowledged.
+class DmaController : public SystemBusDevice {
+public:
+    /// @brief Constructor.
+    /// @param baseAddr base address of the registers
+    /// @param bus bus the controller transfers on and is registered with
+    DmaController(const Address &baseAddr, SystemBus &bus);
+
+    void storeByte(const Address &addr, uint8_t val);
+    uint8_t readByte(const Address &addr);
+    bool decodeAddress(const Address &in, Address &out);
+    bool getAddressRange(uint32_t &first, uint32_t &size);
+    void addCycles(int cycles);
+    void saveState(DeviceState &state);
+    void restoreState(DeviceState &state);
+    void addMetrics(MetricsGroup &group);
+
+private:
+    // Base address.
+    uint32_t mBase;
+
+    // Bus used for the transfer.
+    SystemBus &mBus;
+
+    // IRQ source bit.
+    uint32_t mIrqSource;
+
+    // Registers.
+    uint32_t mSource;
+    uint32_t mDest;
+    uint32_t mCount;
+    uint8_t mControl;
+    uint8_t mStatus;
+
+    // Cycles toward the next byte in cycle-stealing mode.
+    int mCredit;
+
+    // Cycles stolen in addCycles that the bus will pass back to it.
+    int mOwed;
+
+    // Begin the transfer set up in the registers.
+    void start();
+    // Move up to the given number of bytes.
+    void transfer(uint32_t bytes);
+    // Finish the transfer.
+    void complete();
+    // Charge the CPU for moving the given number of bytes.
+    // Returns the cycles stalled.
+    int steal(uint32_t bytes);
+};
+
+#endif // DMA_CONTROLLER_HPP_INCLUDED
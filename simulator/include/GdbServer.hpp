@@ -0,0 +1,117 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef GDB_SERVER_HPP_INCLUDED
+#define GDB_SERVER_HPP_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "Machine.hpp"
+
+class Metrics;
+class Rewind;
+
+/// @brief GDB remote serial protocol server for a machine.
+/// @details
+/// Serves one debugger at a time over a loopback TCP port or a Unix
+/// socket. Registers and memory are read and written directly, Z0/Z1 map
+/// onto the machine's breakpoints and Z2-Z4 onto bus watchpoints.
+/// Continuing runs the core through Machine::run, in slices between
+/// which the connection is checked for an interrupt and periodic metrics
+/// are exported, so the debugged program runs at full speed and nothing
+/// is traced.
+///
+/// The registers, described to the debugger in target.xml, are pc (the
+/// 24-bit program address), a, x, y, sp, d, dbr, p and e, in that order.
+///
+/// Given a Rewind, running forward takes its checkpoints and the reverse
+/// step and continue packets (bs, bc) go back through them, so GDB's
+/// reverse-stepi and reverse-continue work. Registers and memory changed
+/// from the debugger are not part of that history.
+class GdbServer {
+public:
+    explicit GdbServer(Machine &machine);
+    ~GdbServer();
+
+    /// @brief Start listening for a debugger.
+    /// @param where TCP port on the loopback interface, or the path of
+    /// a Unix socket to create
+    /// @param error set to the reason when the socket cannot be opened
+    /// @return false if the socket cannot be opened
+    bool listen(const std::string &where, std::string &error);
+
+    /// @brief Wait for a debugger and serve it until it detaches, kills
+    /// the program or drops the connection.
+    /// @param error set to the reason when no debugger could connect
+    /// @return false if accepting a connection failed
+    bool serve(std::string &error);
+
+    /// @brief Keep history for reverse execution.
+    /// @param rewind checkpoints of the same machine, or null for none
+    void setRewind(Rewind *rewind) { mRewind = rewind; }
+
+    /// @brief Export metrics periodically while continuing.
+    /// @param metrics metrics polled between slices, or null for none
+    void setMetrics(Metrics *metrics) { mMetrics = metrics; }
+
+    /// @brief Why the machine last stopped running.
+    StopReason lastStop() const { return mLastStop; }
+
+private:
+    Machine &mMachine;
+    intptr_t mListener;
+    intptr_t mConnection;
+    std::string mSocketPath;
+    bool mNoAck;
+    StopReason mLastStop;
+    Rewind *mRewind;
+    Metrics *mMetrics;
+
+    // Received bytes not yet used.
+    std::string mInput;
+
+    // Watchpoint ids by Z packet type, address and length.
+    std::map<std::tuple<char, uint32_t, uint32_t>, int> mWatches;
+
+    bool readByte(char &c);
+    bool readPacket(std::string &packet);
+    bool sendPacket(const std::string &data);
+    bool interruptRequested();
+    void closeSocket(intptr_t &fd);
+
+    std::string handle(const std::string &packet, bool &done);
+    std::string resume(bool step);
+    std::string reverse(bool step);
+    StopReason run(uint64_t maxCycles, unsigned stopConditions);
+    std::string stopReply(StopReason reason);
+    const char *watchName(const Watchpoints::Hit &hit) const;
+    std::string readRegisters();
+    bool writeRegister(unsigned number, const std::string &hex);
+    std::string readMemory(const std::string &args);
+    std::string writeMemory(const std::string &args);
+    std::string changePoint(const std::string &args, bool insert);
+    std::string query(const std::string &packet);
+
+    // Disallow copy construction and assignment.
+    GdbServer(const GdbServer &);
+    GdbServer &operator=(const GdbServer &);
+};
+
+#endif // GDB_SERVER_HPP_INCLUDED
@@ -0,0 +1,125 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef HOST_SERVICES_HPP_INCLUDED
+#define HOST_SERVICES_HPP_INCLUDED
+
+#include <cstdint>
+
+#include "Cpu65816.hpp"
+#include "SystemBus.hpp"
+
+// Signature bytes of the standard services.
+#define HOST_MUL32      0x01
+#define HOST_DIV32      0x02
+#define HOST_UL2A       0x03
+#define HOST_MEMFILL    0x04
+#define HOST_MEMCPY     0x05
+#define HOST_MEMCMP     0x06
+#define HOST_STRLEN     0x07
+
+/// @brief Host functions called by the guest through WDM.
+/// @details
+/// The byte after WDM selects a service. Guests probe for one with
+///
+///     sec
+///     .byte $42, id       ; WDM id
+///     bcs software        ; no service: WDM was a no-op
+///
+/// A service that handles the call clears carry, may change A, X and Y
+/// and guest memory, and is charged its cycle cost. Without services, or
+/// when a service declines (for example because the register widths are
+/// wrong), WDM stays a two-byte no-op, as on real hardware.
+///
+/// The standard services, all in native mode with 16-bit registers
+/// except ul2a:
+/// - mul32: 32-bit values at direct page X and X+4; the 64-bit product
+///   goes to X+8.
+/// - div32: dividend at direct page X, divisor at X+4; quotient to X+8
+///   and remainder to X+12. Declines division by zero.
+/// - ul2a: m_ul2a after its php, so the 32-bit number is at 4,S and the
+///   buffer address in the data bank at 8,S. Writes 12 decimal digits
+///   and a zero, as m_ul2a does.
+/// - memfill: store A's low byte to Y bytes from X in the data bank.
+/// - memcpy: copy A bytes from X to Y in the data bank, as memmove does.
+/// - memcmp: compare A bytes at X and Y in the data bank; A becomes 0,
+///   1 or $FFFF as the bytes at X are equal, greater or less.
+/// - strlen: length of the zero-terminated string at X in the data bank
+///   into A.
+class HostServices {
+public:
+    /// @brief Service function.
+    /// @param registers CPU registers; changes to A, X and Y are kept
+    /// @param bus guest memory
+    /// @param bytes set to the number of bytes processed, for the
+    /// per-byte cost
+    /// @return true if the call was handled
+    typedef bool (*Handler)(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &bytes);
+
+    /// @brief Constructor; registers the standard services.
+    HostServices();
+
+    /// @brief Register a service, replacing any with the same signature.
+    /// @param signature byte after WDM
+    /// @param name service name
+    /// @param handler service function
+    /// @param cycles cycles charged per call, on top of WDM's own two
+    /// @param cyclesPerByte cycles charged per byte processed
+    void add(uint8_t signature, const char *name, Handler handler, uint32_t cycles, uint32_t cyclesPerByte = 0);
+
+    /// @brief Unregister a service, so its probe falls back to software.
+    void remove(uint8_t signature);
+
+    /// @brief Change the cost of a service.
+    /// @return false if there is no such service
+    bool setCost(uint8_t signature, uint32_t cycles, uint32_t cyclesPerByte);
+
+    /// @brief Look up a service by name.
+    /// @return signature byte, or -1 if there is no such service
+    int find(const char *name) const;
+
+    /// @brief Call the service for a signature byte.
+    /// @param signature byte after WDM
+    /// @param registers CPU registers
+    /// @param bus guest memory
+    /// @param cycles set to the cycles to charge when handled
+    /// @return true if a service handled the call
+    bool call(uint8_t signature, Cpu65816::Registers &registers, SystemBus &bus, uint32_t &cycles) {
+        Service &service = mServices[signature];
+        uint32_t bytes = 0;
+        if (!service.handler || !service.handler(registers, bus, bytes)) return false;
+        ++service.calls;
+        cycles = service.cycles + bytes * service.cyclesPerByte;
+        return true;
+    }
+
+    /// @brief Number of calls a service has handled.
+    uint64_t calls(uint8_t signature) const { return mServices[signature].calls; }
+
+private:
+    struct Service {
+        const char *name;
+        Handler handler;
+        uint32_t cycles;
+        uint32_t cyclesPerByte;
+        uint64_t calls;
+    };
+
+    Service mServices[256];
+};
+
+#endif // HOST_SERVICES_HPP_INCLUDED
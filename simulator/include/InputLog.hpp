@@ -0,0 +1,105 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef INPUT_LOG_HPP_INCLUDED
+#define INPUT_LOG_HPP_INCLUDED
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/// @brief Record of the bytes UARTs received from outside, for replay.
+/// @details
+/// While recording, each byte a UART reads from its terminal is written
+/// with the cycle it arrived at and the UART's base address, one per
+/// line:
+///
+///     # dt65pc input log: CYCLE UART BYTE
+///     1520384 00:B000 41
+///
+/// While replaying, UARTs take their input from the log instead of the
+/// terminal, each byte at the cycle it was recorded at, so a run that
+/// started from the same state repeats exactly. Once the log runs out
+/// there is no more input. Each UART keeps its place in the log with
+/// its saved state, so going back to a checkpoint replays the same
+/// bytes again.
+class InputLog {
+public:
+    InputLog();
+
+    /// @brief Start recording.
+    /// @param filename log to write
+    /// @param error set to the reason when the log cannot be written
+    /// @return false if the log cannot be written
+    bool record(const std::string &filename, std::string &error);
+
+    /// @brief Read a log to replay.
+    /// @param filename log to read
+    /// @param error set to the file, line and reason when it is rejected
+    /// @return false if the log cannot be read or is not valid
+    bool replay(const std::string &filename, std::string &error);
+
+    bool replaying() const { return mReplaying; }
+
+    /// @brief Record a byte a UART received.
+    /// @param uart 24-bit base address of the UART
+    /// @param cycle cycle the byte arrived at
+    /// @param val the byte
+    void put(uint32_t uart, uint64_t cycle, uint8_t val);
+
+    /// @brief Take the next byte for a UART if it is due.
+    /// @param uart 24-bit base address of the UART
+    /// @param cycle current cycle
+    /// @return the byte, or -1 if none is due yet
+    int take(uint32_t uart, uint64_t cycle);
+
+    /// @brief Number of bytes taken for a UART so far.
+    /// @param uart 24-bit base address of the UART
+    size_t position(uint32_t uart) const;
+
+    /// @brief Return to an earlier point in a UART's input, as when its
+    /// saved state is restored.
+    /// @param uart 24-bit base address of the UART
+    /// @param position a count returned by position
+    void seek(uint32_t uart, size_t position);
+
+private:
+    struct Event {
+        uint64_t cycle;
+        uint8_t val;
+    };
+
+    struct Stream {
+        std::vector<Event> events;
+        // Index of the next byte to replay.
+        size_t next = 0;
+    };
+
+    std::ofstream mOut;
+    bool mReplaying;
+
+    // Bytes to replay, by UART.
+    std::map<uint32_t, Stream> mEvents;
+
+    // Disallow copy construction and assignment.
+    InputLog(const InputLog &);
+    InputLog &operator=(const InputLog &);
+};
+
+#endif // INPUT_LOG_HPP_INCLUDED
@@ -0,0 +1,61 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef INTEL_HEX_HPP_INCLUDED
+#define INTEL_HEX_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Contents of an Intel HEX file.
+/// @details
+/// Data records are gathered into runs of consecutive addresses, in file
+/// order. Extended segment and extended linear address records are
+/// applied, and the last start address record is kept. Every address
+/// must fall in the 24-bit address space.
+class IntelHex {
+public:
+    struct Run {
+        uint32_t address;
+        std::vector<uint8_t> bytes;
+    };
+
+    /// @brief Check for the .hex extension, in any case.
+    static bool isHexFile(const std::string &filename);
+
+    /// @brief Read and check a file.
+    /// @param filename file to read
+    /// @param error set to the file, line and reason when it is rejected
+    /// @return false if the file cannot be read or is not valid
+    bool read(const std::string &filename, std::string &error);
+
+    const std::vector<Run> &runs() const { return mRuns; }
+
+    /// @brief Check for a start address record.
+    bool hasStart() const { return mHasStart; }
+
+    /// @brief Start address, from a start segment or start linear record.
+    uint32_t start() const { return mStart; }
+
+private:
+    std::vector<Run> mRuns;
+    bool mHasStart = false;
+    uint32_t mStart = 0;
+};
+
+#endif // INTEL_HEX_HPP_INCLUDED
@@ -21,6 +21,32 @@
 #ifndef INTERRUPT_HPP
 #define INTERRUPT_HPP
 
-// TODO Add needed interrupt support code.
+#include <cstdint>
+
+/// @brief Level-triggered IRQ line shared by the devices on the bus.
+/// @details
+/// Each device that can interrupt takes a source bit and asserts it
+/// until the condition is acknowledged; the line is active while any
+/// source is asserted, as with open-collector outputs wired together.
+class InterruptLine {
+    public:
+        /// @brief Allocate a source bit for a device.
+        /// @return the bit, or 0 once all 32 are taken
+        uint32_t addSource() {
+            const uint32_t source = mNextSource;
+            mNextSource <<= 1;
+            return source;
+        }
+
+        void assertSource(uint32_t source) { mAsserted |= source; }
+        void releaseSource(uint32_t source) { mAsserted &= ~source; }
+
+        /// @brief Check for any source holding the line active.
+        bool asserted() const { return mAsserted != 0; }
+
+    private:
+        uint32_t mAsserted = 0;
+        uint32_t mNextSource = 1;
+};
 
 #endif // INTERRUPT_HPP
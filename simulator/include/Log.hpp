@@ -26,14 +26,20 @@
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <mutex>
 
+/// @brief Tagged log output.
+/// @details
+/// Each thread builds its messages in its own buffers; show() writes
+/// them out one whole line at a time.
 class Log {
     private:
-        static Log sDebugLog;
-        static Log sVerboseLog;
-        static Log sTraceLog;
-        static Log sErrorLog;
+        static thread_local Log sDebugLog;
+        static thread_local Log sVerboseLog;
+        static thread_local Log sTraceLog;
+        static thread_local Log sErrorLog;
         static std::ofstream sOut;
+        static std::mutex sOutMutex;
         
         Log(const bool);
         const char *mTag;
@@ -83,13 +89,13 @@ class Log {
         /// @brief Write a decimal value.
         /// @param val integer value
         /// @return this, for chaining
-        Log &dec(uint32_t val);
+        Log &dec(uint64_t val);
 
         /// @brief Write a decimal value.
         /// @param val integer value
         /// @param w width in characters
         /// @return this, for chaining
-        Log &dec(uint32_t val, uint8_t w);
+        Log &dec(uint64_t val, uint8_t w);
 
         /// @brief Write a space.
         /// @return this, for chaining
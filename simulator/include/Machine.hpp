@@ -0,0 +1,135 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef MACHINE_HPP_INCLUDED
+#define MACHINE_HPP_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Breakpoints.hpp"
+#include "Cpu65816.hpp"
+#include "SystemBus.hpp"
+#include "SystemBusDevice.hpp"
+
+class Terminal;
+
+// Conditions Machine::run stops on besides STP and the cycle budget,
+// OR'd together.
+#define STOP_ON_BREAKPOINT  1
+#define STOP_ON_WATCHPOINT  2
+#define STOP_ON_DEVICE      4
+#define STOP_ON_ALL         (STOP_ON_BREAKPOINT | STOP_ON_WATCHPOINT | STOP_ON_DEVICE)
+
+/// @brief Why Machine::run returned.
+enum class StopReason : uint8_t {
+    Stp,            ///< the CPU executed STP
+    Breakpoint,     ///< the PC reached a breakpoint
+    Watchpoint,     ///< a watchpoint triggered; see SystemBus::watchpoints
+    CycleBudget,    ///< the cycles given to run were used up
+    DeviceRequest,  ///< a device or host service called SystemBus::requestStop
+    Unimplemented,  ///< the next opcode has no implementation
+    HistoryStart    ///< running backward reached the oldest checkpoint
+};
+
+/// @brief Printable name of a stop reason.
+const char *stopReasonName(StopReason reason);
+
+/// @brief A CPU and the devices on its bus.
+/// @details
+/// Devices are added in priority order, as on the system bus, so RAM
+/// goes last. The add methods return the machine for chaining:
+///
+///     Machine machine;
+///     machine.addRom(Address(0x00, 0xC000), "dt65pc.rom").addRam(0x80);
+///     machine.reset();
+///     StopReason reason = machine.run(1000000, STOP_ON_BREAKPOINT);
+class Machine {
+public:
+    Machine();
+
+    /// @brief Add a ROM image.
+    /// @param base base address
+    /// @param filename image file
+    Machine &addRom(const Address &base, const std::string &filename);
+
+    /// @brief Add a UART.
+    /// @param base base address
+    /// @param term terminal on the serial line, or null for none
+    Machine &addUart(const Address &base, Terminal *term = 0);
+
+    /// @brief Add a math coprocessor.
+    /// @param base base address
+    Machine &addMathUnit(const Address &base);
+
+    /// @brief Add a DMA controller transferring on this machine's bus.
+    /// @param base base address
+    Machine &addDma(const Address &base);
+
+    /// @brief Add RAM from address 0.
+    /// @param banks number of 64K banks, 1 to 0x100
+    Machine &addRam(uint16_t banks);
+
+    /// @brief Add a device the caller owns.
+    Machine &addDevice(SystemBusDevice *device);
+
+    /// @brief Add a device for the machine to own.
+    Machine &addDevice(std::unique_ptr<SystemBusDevice> device);
+
+    /// @brief Copy a program into memory, before or after reset.
+    /// @details
+    /// The bytes are stored as the CPU would store them, so ROM is left
+    /// alone, but runs of RAM are copied in bulk.
+    /// @param filename raw binary, such as ld65 writes, or Intel HEX (.hex)
+    /// @param address where a binary goes; added to Intel HEX addresses
+    /// @param error set to the reason when the program cannot be loaded
+    /// @return false if the file cannot be read or does not fit in memory
+    bool load(const std::string &filename, uint32_t address, std::string &error);
+
+    /// @brief Cycle the reset line, starting the CPU from the reset vector.
+    void reset();
+
+    /// @brief Execute instructions until a stop condition or the budget.
+    /// @details
+    /// STP and the cycle budget always stop. Breakpoints, watchpoints and
+    /// device requests stop only when asked for in stopConditions. Nothing
+    /// is called back per instruction; for a breakpoint the PC is left at
+    /// the breakpoint, and the next run executes it.
+    /// @param maxCycles cycles to run at most, overshooting by at most one
+    /// instruction
+    /// @param stopConditions STOP_ON_* flags
+    StopReason run(uint64_t maxCycles, unsigned stopConditions = STOP_ON_ALL);
+
+    Cpu65816 &cpu() { return mCpu; }
+    SystemBus &bus() { return mSystemBus; }
+    BreakpointSet &breakPoints() { return mBreakPoints; }
+
+private:
+    // Declared first so that devices outlive the bus and CPU.
+    std::vector<std::unique_ptr<SystemBusDevice>> mDevices;
+    SystemBus mSystemBus;
+    Cpu65816 mCpu;
+    BreakpointSet mBreakPoints;
+
+    // Disallow copy construction and assignment.
+    Machine(const Machine &);
+    Machine &operator=(const Machine &);
+};
+
+#endif // MACHINE_HPP_INCLUDED
@@ -0,0 +1,93 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef MACHINE_DESCRIPTION_HPP_INCLUDED
+#define MACHINE_DESCRIPTION_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Machine.hpp"
+
+class InputLog;
+class Terminal;
+
+/// @brief Memory map and settings read from a machine description file.
+/// @details
+/// The file has one device or setting per line, and # starts a comment:
+///
+///     clock 8000000
+///     mode trace
+///     rom 00:C000 ../kernel/dt65pc.rom
+///     uart 00:B000 console
+///     mathunit 00:B200
+///     dma 00:B300
+///     ram 0x80
+///
+/// ROM and disk image paths are relative to the description file. RAM always
+/// starts at $00:0000 and lies beneath every other device; no other
+/// devices may overlap.
+class MachineDescription {
+public:
+    enum class DeviceKind : uint8_t {
+        Rom,
+        Uart,
+        MathUnit,
+        Dma,
+        Disk,
+        Ram
+    };
+
+    struct Device {
+        DeviceKind kind;
+        uint32_t base;          ///< 24-bit base address
+        uint32_t size;          ///< bytes reserved, or 0 for the image size
+        std::string path;       ///< ROM or disk image
+        bool console;           ///< UART attached to the console
+        int line;               ///< line of the description
+    };
+
+    /// @brief Read a description.
+    /// @param filename description file
+    /// @param error set to the reason when the description is rejected
+    /// @return false if the file could not be read or is invalid
+    bool load(const std::string &filename, std::string &error);
+
+    /// @brief Add the devices to a machine, checking the memory map.
+    /// @param machine machine with no devices yet
+    /// @param console terminal for UARTs attached to the console
+    /// @param error set to the reason when the map is rejected
+    /// @param input log recording or replaying the UARTs' input, or null
+    /// @return false if an image cannot be read or devices overlap
+    bool build(Machine &machine, Terminal *console, std::string &error, InputLog *input = 0) const;
+
+    const std::vector<Device> &devices() const { return mDevices; }
+
+    /// @brief CPU clock in Hz.
+    uint32_t clock() const { return mClock; }
+
+    /// @brief Trace every instruction to the log.
+    bool trace() const { return mTrace; }
+
+private:
+    std::vector<Device> mDevices;
+    uint32_t mClock = 8000000;
+    bool mTrace = true;
+};
+
+#endif // MACHINE_DESCRIPTION_HPP_INCLUDED
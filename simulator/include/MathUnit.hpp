@@ -0,0 +1,97 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef MATH_UNIT_HPP_INCLUDED
+#define MATH_UNIT_HPP_INCLUDED
+
+#include "SystemBusDevice.hpp"
+
+// Register offsets from the base address.
+#define MATH_OPA        0x00    ///< operand A, 64 bits
+#define MATH_OPB        0x08    ///< operand B, 32 bits
+#define MATH_RESULT     0x10    ///< result, 64 bits
+#define MATH_REMAINDER  0x18    ///< remainder, 40 bits
+#define MATH_CONTROL    0x1F    ///< command on write, status on read
+
+// Commands written to MATH_CONTROL.
+#define MATH_MUL        0x01    ///< RESULT = OPA[31:0] * OPB
+#define MATH_DIV        0x02    ///< RESULT = OPA / OPB, REMAINDER = OPA % OPB
+#define MATH_SQRT       0x03    ///< RESULT = isqrt(OPA), REMAINDER = OPA - RESULT^2 (up to 33 bits)
+#define MATH_BIN2BCD    0x04    ///< RESULT = OPA[31:0] as ten packed BCD digits
+#define MATH_BCD2BIN    0x05    ///< RESULT = ten packed BCD digits in OPA as binary
+
+// Status bits read from MATH_CONTROL.
+#define MATH_BUSY       0x80    ///< operation in progress
+#define MATH_ERROR      0x40    ///< division by zero or invalid BCD
+
+/// @brief Memory-mapped arithmetic coprocessor.
+/// @details
+/// Occupies 32 bytes. All multi-byte registers are little-endian, as the
+/// CPU stores them. Writing a command to the control register latches
+/// the operands and sets MATH_BUSY; the result and remainder registers
+/// keep their old values until the modeled latency has elapsed, after
+/// which MATH_BUSY clears. Writing a command while busy abandons the
+/// operation in progress. Packed BCD is stored least significant digit
+/// pair first, as m_ultemp2bcd leaves it in the scratchpad.
+class MathUnit : public SystemBusDevice {
+public:
+    /// @brief Constructor.
+    /// @param baseAddr base address of the register file
+    MathUnit(const Address &baseAddr);
+
+    void storeByte(const Address &addr, uint8_t val);
+    uint8_t readByte(const Address &addr);
+    bool decodeAddress(const Address &in, Address &out);
+    bool getAddressRange(uint32_t &first, uint32_t &size);
+    void addCycles(int cycles);
+    void saveState(DeviceState &state);
+    void restoreState(DeviceState &state);
+    void addMetrics(MetricsGroup &group);
+
+    /// @brief Latency of a command in CPU cycles.
+    /// @param command MATH_MUL through MATH_BCD2BIN
+    static int latency(uint8_t command);
+
+private:
+    // Base address.
+    uint32_t mBase;
+
+    // Operand registers.
+    uint64_t mOperandA;
+    uint32_t mOperandB;
+
+    // Visible result registers.
+    uint64_t mResult;
+    uint64_t mRemainder;
+
+    // Results of the operation in progress, made visible on completion.
+    uint64_t mPendingResult;
+    uint64_t mPendingRemainder;
+
+    // Last command and the MATH_BUSY and MATH_ERROR bits.
+    uint8_t mStatus;
+
+    // Cycles until the operation in progress completes.
+    int mCyclesLeft;
+
+    // Run a command on the latched operands.
+    void start(uint8_t command);
+    // Make the pending results visible.
+    void complete();
+};
+
+#endif // MATH_UNIT_HPP_INCLUDED
@@ -0,0 +1,139 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef METRICS_HPP_INCLUDED
+#define METRICS_HPP_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Machine;
+
+// Size of a host cache line; counters are spaced this far apart.
+#define METRICS_CACHE_LINE 64
+
+/// @brief Counters each on a cache line of its own.
+/// @details
+/// A counter is written only by the thread running its machine and read
+/// when metrics are exported. Spacing them a line apart keeps counters of
+/// machines run on different threads from sharing lines, so counting
+/// costs a plain increment.
+class CounterSlots {
+public:
+    explicit CounterSlots(size_t count = 0);
+
+    /// @brief Change the number of counters, keeping their values.
+    void resize(size_t count);
+
+    size_t size() const { return mCount; }
+
+    uint64_t &operator[](size_t i) { return mBase[i * SLOT_WORDS]; }
+    uint64_t operator[](size_t i) const { return mBase[i * SLOT_WORDS]; }
+
+private:
+    static const size_t SLOT_WORDS = METRICS_CACHE_LINE / sizeof(uint64_t);
+
+    std::vector<uint64_t> mStorage;
+    uint64_t *mBase;
+    size_t mCount;
+
+    // Disallow copy construction and assignment.
+    CounterSlots(const CounterSlots &);
+    CounterSlots &operator=(const CounterSlots &);
+};
+
+/// @brief Values describing one device in a metrics export.
+class MetricsGroup {
+public:
+    /// @param kind kind of device, such as "uart"
+    explicit MetricsGroup(const char *kind = "device") : mKind(kind) {}
+
+    /// @brief Name the kind of device, such as "uart".
+    void setKind(const char *kind) { mKind = kind; }
+    const char *kind() const { return mKind; }
+
+    /// @brief Add a named value.
+    void add(const char *name, uint64_t value);
+    void add(const char *name, double value);
+
+    /// @brief Write the values as the members of a JSON object.
+    void write(std::ostream &out) const;
+
+private:
+    const char *mKind;
+    std::vector<std::pair<const char *, std::string>> mValues;
+};
+
+/// @brief Runtime metrics of a machine, exported as JSON.
+/// @details
+/// Gathers the CPU's counters, the bus accesses that reached each device
+/// and each device's own counters into one JSON object:
+///
+///     {"instructions":..., "cycles":..., "seconds":..., "mhz":...,
+///      "interrupts":..., "wai":..., "devices":{"uart@00:B000":{...}}}
+///
+/// seconds is host time since the metrics were created and mhz the
+/// emulated clock achieved over it. The export goes to a file, rewritten
+/// each time, or on POSIX hosts to a Unix socket that is listening, as
+/// one line per export.
+class Metrics {
+public:
+    explicit Metrics(Machine &machine);
+    ~Metrics();
+
+    /// @brief Choose where exports go.
+    /// @param target file to write, or path of a listening Unix socket
+    /// @param error set to the reason when the socket cannot be reached
+    /// @return false if the target is a socket that cannot be reached
+    bool open(const std::string &target, std::string &error);
+
+    /// @brief Export every so often from poll.
+    /// @param milliseconds host time between exports, or 0 for none
+    void setInterval(uint32_t milliseconds) { mInterval = std::chrono::milliseconds(milliseconds); }
+    bool periodic() const { return mInterval.count() != 0; }
+
+    /// @brief Export if the interval has passed since the last export.
+    void poll();
+
+    /// @brief Export now.
+    /// @return false if the target could not be written
+    bool write();
+
+    /// @brief Write the metrics as one line of JSON.
+    void write(std::ostream &out) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Machine &mMachine;
+    std::string mTarget;
+    intptr_t mSocket;
+    Clock::time_point mStart;
+    Clock::time_point mLastWrite;
+    std::chrono::milliseconds mInterval;
+
+    // Disallow copy construction and assignment.
+    Metrics(const Metrics &);
+    Metrics &operator=(const Metrics &);
+};
+
+#endif // METRICS_HPP_INCLUDED
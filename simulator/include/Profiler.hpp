@@ -0,0 +1,72 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef PROFILER_HPP_INCLUDED
+#define PROFILER_HPP_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "SystemBusDevice.hpp"
+#include "Symbols.hpp"
+
+/// @brief Flat execution profile: instructions and cycles per address.
+/// @details
+/// Counters are stored in 256-entry arrays allocated the first time code
+/// in a page executes, so recording an instruction is a page table load
+/// and an increment.
+class Profiler {
+public:
+    Profiler();
+
+    /// @brief Count one executed instruction.
+    /// @param addr 24-bit address of the opcode
+    /// @param cycles cycles the instruction took
+    void record(uint32_t addr, uint32_t cycles) {
+        Counter *page = mPages[addr >> 8];
+        if (!page) page = allocatePage(addr >> 8);
+        Counter &counter = page[addr & 0xFF];
+        ++counter.count;
+        counter.cycles += cycles;
+    }
+
+    /// @brief Forget all counts.
+    void clear();
+
+    /// @brief Write the hot-spot report.
+    /// @details
+    /// Lists time per routine, then the busiest individual addresses.
+    /// @param out stream to write to
+    /// @param symbols symbols used to name addresses
+    /// @param limit maximum number of lines in each section
+    void report(std::ostream &out, const Symbols &symbols, size_t limit = 50) const;
+
+private:
+    struct Counter {
+        uint64_t count;
+        uint64_t cycles;
+    };
+
+    std::vector<Counter *> mPages;
+    std::vector<std::unique_ptr<Counter[]>> mStorage;
+
+    Counter *allocatePage(uint32_t page);
+};
+
+#endif // PROFILER_HPP_INCLUDED
@@ -31,17 +31,20 @@
 class Ram : public SystemBusDevice {
 public:
     /// @brief Constructor
-    /// @param banks Number of 64K banks
-    explicit Ram(uint8_t banks);
+    /// @param banks Number of 64K banks, up to 0x100 for the whole address space
+    explicit Ram(uint16_t banks);
     ~Ram();
 
     void storeByte(const Address &, uint8_t);
     uint8_t readByte(const Address &);
     bool decodeAddress(const Address &, Address &);
+    bool getAddressRange(uint32_t &, uint32_t &);
+    uint8_t *getPagePointer(const Address &, bool);
+    void addMetrics(MetricsGroup &);
 
 private:
     // Number of banks.
-    uint8_t mBanks;
+    uint16_t mBanks;
     
     // Raw bytes.
     uint8_t *mRam;
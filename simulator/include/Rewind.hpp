@@ -0,0 +1,117 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef REWIND_HPP_INCLUDED
+#define REWIND_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "DeviceState.hpp"
+#include "Machine.hpp"
+
+/// @brief Reverse execution by checkpoints and deterministic replay.
+/// @details
+/// While running through run(), a checkpoint is taken every interval
+/// cycles: the CPU registers and counters and every device's registers.
+/// Memory is copied on write: the bus reports the first write to each
+/// page after a checkpoint, and only that page's old contents are kept,
+/// so a checkpoint costs what the program actually changed.
+///
+/// Going back restores the nearest checkpoint at or before the target
+/// and executes forward to it. That is exact as long as the machine is
+/// deterministic. Input replayed from an InputLog goes back with the
+/// UARTs' state, but input typed at a console UART while re-executing is
+/// not the input originally seen. Checkpoints after the point restored
+/// are dropped and made again when running forward.
+///
+/// At most ringSize checkpoints are kept, oldest dropped first, which
+/// bounds how far back execution can go and how much memory it costs.
+class Rewind : private PageObserver {
+public:
+    /// @brief Start recording a machine's history.
+    /// @param machine machine to record; its devices must all be on its bus
+    /// @param interval cycles between checkpoints
+    /// @param ringSize most checkpoints kept
+    Rewind(Machine &machine, uint64_t interval, size_t ringSize);
+    ~Rewind();
+
+    /// @brief Run forward as Machine::run does, taking checkpoints.
+    StopReason run(uint64_t maxCycles, unsigned stopConditions = STOP_ON_ALL);
+
+    /// @brief Go back one instruction.
+    /// @return false if there is no history before this point
+    bool stepBack();
+
+    /// @brief Go back to the most recent point where the PC reached a
+    /// breakpoint or a watchpoint triggered.
+    /// @details
+    /// Breakpoint hit counts are not changed. After a watchpoint, the
+    /// hits of the instruction that triggered it are left on the bus.
+    /// @return Breakpoint, Watchpoint, or HistoryStart when there is
+    /// neither and execution is left at the oldest checkpoint
+    StopReason continueBack();
+
+    /// @brief Go to an earlier instruction count.
+    /// @param instruction instruction count to stop at
+    /// @return false if the count is before the oldest checkpoint or in
+    /// the future
+    bool goTo(uint64_t instruction);
+
+    /// @brief Number of checkpoints kept.
+    size_t checkpoints() const { return mRing.size(); }
+
+    /// @brief Bytes of memory saved across all checkpoints.
+    size_t savedBytes() const;
+
+private:
+    struct SavedPage {
+        uint8_t *memory;
+        uint8_t bytes[PAGE_SIZE_BYTES];
+    };
+
+    struct Checkpoint {
+        Cpu65816::Snapshot cpu;
+        std::vector<DeviceState> devices;
+        // Pages as they were at this checkpoint, saved on first write.
+        std::vector<SavedPage> pages;
+    };
+
+    Machine &mMachine;
+    uint64_t mInterval;
+    size_t mRingSize;
+    std::deque<Checkpoint> mRing;
+
+    // Cycle count of the next checkpoint.
+    uint64_t mNextCheckpoint;
+
+    void beforeFirstWrite(uint32_t page, uint8_t *memory);
+
+    // Take a checkpoint now.
+    void checkpoint();
+    // Index of the newest checkpoint at or before an instruction count,
+    // or -1 if there is none.
+    long find(uint64_t instruction) const;
+    // Go back to a checkpoint, dropping the newer ones.
+    void restore(size_t index);
+    // Execute instructions until the count is reached.
+    void stepTo(uint64_t instruction);
+};
+
+#endif // REWIND_HPP_INCLUDED
@@ -17,8 +17,9 @@
 #ifndef ROM_HPP_INCLUDED
 #define ROM_HPP_INCLUDED
 
+#include <memory>
 #include <string>
-#include <vector>
+#include "RomImage.hpp"
 #include "SystemBusDevice.hpp"
 
 /// @brief ROM device.
@@ -29,13 +30,24 @@ class Rom : public SystemBusDevice {
 public:
     /// @brief Constructor.
     /// @param baseAddr base address
-    /// @param filename file to read ROM data from
+    /// @param filename file to read ROM data from, binary or Intel HEX
     Rom(const Address& baseAddr, const std::string& filename);
+
+    /// @brief Constructor.
+    /// @param baseAddr base address
+    /// @param image image already opened
+    Rom(const Address& baseAddr, std::shared_ptr<const RomImage> image);
     ~Rom();
 
+    /// @brief Size in bytes; 0 if the image could not be read.
+    uint32_t size() const { return mSize; }
+
     void storeByte(const Address &, uint8_t) { /* do nothing */ }
     uint8_t readByte(const Address &);
     bool decodeAddress(const Address &, Address &);
+    bool getAddressRange(uint32_t &, uint32_t &);
+    uint8_t *getPagePointer(const Address &, bool);
+    void addMetrics(MetricsGroup &);
 
 private:
     // Disallow copy construction and assignment.
@@ -43,7 +55,9 @@ private:
     Rom& operator=(const Rom&);
 
     uint32_t mBase;
-    std::vector<uint8_t> mRom;
+    std::shared_ptr<const RomImage> mImage;
+    const uint8_t *mRom;
+    uint32_t mSize;
 };
 
 #endif // ROM_HPP_INCLUDED
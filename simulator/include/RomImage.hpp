@@ -0,0 +1,67 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef ROM_IMAGE_HPP_INCLUDED
+#define ROM_IMAGE_HPP_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// @brief Read-only ROM contents, shared by every ROM made from one file.
+/// @details
+/// Binary images, such as ld65 writes, are memory-mapped so that all
+/// instances, in this process or others, use the same pages; an image
+/// rebuilt in place while mapped changes under the running ROM. Intel HEX
+/// files (.hex) are decoded once into memory; their addresses are offsets
+/// from the ROM base, and gaps are filled with zeros.
+class RomImage {
+public:
+    /// @brief Open an image, or share the one already open for the file.
+    /// @param filename image file
+    /// @param error set to the reason when the image cannot be used
+    /// @return the image, or null on error
+    static std::shared_ptr<const RomImage> open(const std::string &filename, std::string &error);
+
+    ~RomImage();
+
+    const uint8_t *data() const { return mData; }
+    uint32_t size() const { return mSize; }
+
+private:
+    const uint8_t *mData = nullptr;
+    uint32_t mSize = 0;
+
+    // Mapped view, if the file is mapped.
+    void *mView = nullptr;
+    size_t mViewSize = 0;
+
+    // Decoded contents, if the file is not mapped.
+    std::vector<uint8_t> mDecoded;
+
+    RomImage() {}
+
+    // Disallow copy construction and assignment.
+    RomImage(const RomImage &);
+    RomImage &operator=(const RomImage &);
+
+    bool map(const std::string &filename, std::string &error);
+    bool decodeHex(const std::string &filename, std::string &error);
+};
+
+#endif // ROM_IMAGE_HPP_INCLUDED
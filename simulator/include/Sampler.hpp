@@ -0,0 +1,115 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef SAMPLER_HPP_INCLUDED
+#define SAMPLER_HPP_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Symbols.hpp"
+
+// Callers kept with each sample.
+#define SAMPLE_STACK_DEPTH 4
+
+/// @brief Statistical profiler sampling the CPU every so many cycles.
+/// @details
+/// The CPU compares its cycle count with a deadline after each
+/// instruction and only calls in here when the deadline passes. Deadlines
+/// are jittered around the interval so that loops in step with it are not
+/// over- or under-counted.
+///
+/// A light shadow stack is kept from calls and returns, matched by stack
+/// pointer like CallGraph. A sample is one word holding the PC and the
+/// number of routines that follow, then the entry addresses of up to
+/// SAMPLE_STACK_DEPTH routines from the innermost out. Samples are
+/// counted per distinct PC and stack as they are taken, so the memory
+/// used grows with the code run rather than with the length of the run.
+class Sampler {
+public:
+    /// @param interval mean cycles between samples
+    /// @param seed jitter generator seed
+    Sampler(uint32_t interval = 1000, uint32_t seed = 1);
+
+    /// @brief Start a new shadow stack.
+    /// @param addr 24-bit address execution starts at
+    /// @param cycles current CPU cycle count
+    /// @return cycle count of the first sample
+    uint64_t start(uint32_t addr, uint64_t cycles);
+
+    /// @brief Enter a subroutine or interrupt handler.
+    /// @param addr 24-bit address of the routine
+    /// @param stackPointer stack pointer after the return address was pushed
+    void enter(uint32_t addr, uint16_t stackPointer);
+
+    /// @brief Return from a subroutine or interrupt handler.
+    /// @param stackPointer stack pointer after the return address was pulled
+    void leave(uint16_t stackPointer);
+
+    /// @brief Take a sample.
+    /// @param pc 24-bit address of the next instruction
+    /// @param cycles current CPU cycle count
+    /// @return cycle count of the next sample
+    uint64_t sample(uint32_t pc, uint64_t cycles);
+
+    /// @brief Number of samples taken or loaded.
+    uint64_t count() const { return mCount; }
+
+    /// @brief Add saved samples to this buffer.
+    /// @param filename file written by save
+    /// @return false if the file could not be read or is not a sample buffer
+    bool load(const std::string &filename);
+
+    /// @brief Save the sample buffer.
+    /// @param filename file to write
+    /// @return false if the file could not be written
+    bool save(const std::string &filename) const;
+
+    /// @brief Write samples per routine and per address.
+    /// @param out stream to write to
+    /// @param symbols symbols used to name addresses
+    /// @param limit maximum number of lines in each section
+    void report(std::ostream &out, const Symbols &symbols, size_t limit = 50) const;
+
+    /// @brief Write sample counts per call path in collapsed-stack form.
+    /// @param out stream to write to
+    /// @param symbols symbols used to name routines
+    void writeCollapsed(std::ostream &out, const Symbols &symbols) const;
+
+private:
+    struct Frame {
+        uint32_t address;
+        uint32_t stackPointer;
+    };
+
+    // PC and depth word, then the routines; unused words are zero.
+    typedef std::array<uint32_t, 1 + SAMPLE_STACK_DEPTH> Stack;
+
+    uint32_t mInterval;
+    uint32_t mRandom;
+    std::vector<Frame> mFrames;
+    std::map<Stack, uint64_t> mSamples;
+    uint64_t mCount;
+
+    uint64_t nextDeadline(uint64_t cycles);
+};
+
+#endif // SAMPLER_HPP_INCLUDED
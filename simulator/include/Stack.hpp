@@ -25,26 +25,66 @@
 
 #define STACK_POINTER_DEFAULT 0x1FF
 
+/// @brief The native stack, always in bank zero.
+/// @details
+/// Host pointers to the page holding the stack pointer are cached, so
+/// pushes and pulls are plain memory accesses until the pointer moves to
+/// another page or the bus changes its page mapping. Pages that are not
+/// plain memory go through the bus as before.
 class Stack {
     public:
 
         Stack(SystemBus *);
         Stack(SystemBus *, uint16_t);
-        
-        void push8Bit(uint8_t);
+
+        void push8Bit(uint8_t value) {
+            if (!cacheIsCurrent()) cachePage();
+            if (mWritePage) {
+                mWritePage[mStackPointer & 0xFF] = value;
+            } else {
+                mSystemBus->storeByte(Address(0x00, mStackPointer), value);
+            }
+            --mStackPointer;
+        }
+
         void push16Bit(uint16_t);
-        
-        uint8_t pull8Bit();
+
+        uint8_t pull8Bit() {
+            ++mStackPointer;
+            if (!cacheIsCurrent()) cachePage();
+            if (mReadPage) {
+                return mReadPage[mStackPointer & 0xFF];
+            }
+            return mSystemBus->readByte(Address(0x00, mStackPointer));
+        }
+
         uint16_t pull16Bit();
-        
+
         uint16_t getStackPointer();
 
+        /// @brief Move the stack pointer without logging, as TCS and TXS do.
+        /// @param stackPointer new offset in bank zero
+        void setStackPointer(uint16_t stackPointer) { mStackPointer = stackPointer; }
+
         /// @brief Set high byte of stack pointer to reset to page one.
         void setEmulation();
-        
+
     private:
         SystemBus *mSystemBus;
-        Address mStackAddress;
+        // Offsets wrap within bank zero, as the 16-bit pointer does.
+        uint16_t mStackPointer;
+
+        // Page the cached pointers belong to, and the bus mapping they
+        // were taken from. NO_PAGE forces a lookup on first use.
+        uint16_t mCachedPage;
+        uint32_t mCachedGeneration;
+        const uint8_t *mReadPage;
+        uint8_t *mWritePage;
+
+        bool cacheIsCurrent() const {
+            return (mStackPointer >> 8) == mCachedPage && mCachedGeneration == mSystemBus->generation();
+        }
+        void cachePage();
 };
 
 #endif // STACK_HPP_INCLUDED
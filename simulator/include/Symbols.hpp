@@ -0,0 +1,84 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef SYMBOLS_HPP_INCLUDED
+#define SYMBOLS_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Address to name mapping built from the kernel build outputs.
+/// @details
+/// Understands the ld65 label file (-Ln) and map file (-m) and the ca65
+/// listing (-l). Labels inside a .proc found in a listing are qualified
+/// with the procedure name, as in "m_b2a::next_byte".
+class Symbols {
+public:
+    /// @brief Load symbols, choosing the format from the file extension
+    /// (.lbl/.lab label file, .map map file, .lst listing).
+    /// @param filename file to read
+    /// @return false if the file could not be read
+    bool load(const std::string &filename);
+
+    /// @brief Load an ld65 VICE label file ("al 00C100 .name" lines).
+    bool loadLabels(const std::string &filename);
+
+    /// @brief Load the exports list from an ld65 map file.
+    bool loadMap(const std::string &filename);
+
+    /// @brief Load labels and procedures from a ca65 listing.
+    bool loadListing(const std::string &filename);
+
+    /// @brief Add one symbol.
+    /// @param addr 24-bit address
+    /// @param name symbol name
+    void add(uint32_t addr, const std::string &name);
+
+    /// @brief Check for no symbols loaded.
+    bool empty() const { return mSymbols.empty(); }
+
+    /// @brief Find the closest symbol at or below an address.
+    /// @param addr 24-bit address
+    /// @param offset distance from the symbol to the address
+    /// @return symbol name, or null if there is none in the same bank
+    const std::string *lookup(uint32_t addr, uint32_t &offset) const;
+
+    /// @brief Format an address as "name+$offset", or as a plain hex
+    /// address when no symbol covers it.
+    /// @param addr 24-bit address
+    std::string describe(uint32_t addr) const;
+
+    /// @brief Name of the routine containing an address: the symbol with
+    /// any "::label" suffix removed.
+    /// @param addr 24-bit address
+    std::string routine(uint32_t addr) const;
+
+private:
+    struct Symbol {
+        uint32_t address;
+        std::string name;
+    };
+
+    // Sorted by address.
+    std::vector<Symbol> mSymbols;
+
+    void append(uint32_t addr, const std::string &name);
+    void sort();
+};
+
+#endif // SYMBOLS_HPP_INCLUDED
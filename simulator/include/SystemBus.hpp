@@ -24,21 +24,190 @@
 #include <cstdint>
 #include <vector>
 
+#include "Interrupt.hpp"
 #include "SystemBusDevice.hpp"
+#include "Metrics.hpp"
+#include "Watchpoints.hpp"
+
+/// @brief Told about memory pages before they change, for checkpoints.
+class PageObserver {
+    public:
+        virtual ~PageObserver() {}
+
+        /// @brief Called before the first write to a page of memory after
+        /// SystemBus::protectPages.
+        /// @param page 24-bit address of the page, shifted right by 8
+        /// @param memory host memory of the page, still unchanged
+        virtual void beforeFirstWrite(uint32_t page, uint8_t* memory) = 0;
+};
 
 class SystemBus {
     public:
+        SystemBus();
+
         void registerDevice(SystemBusDevice* device);
-        void storeByte(const Address& address, uint8_t value);
         void storeTwoBytes(const Address& address, uint16_t value);
-        uint8_t readByte(const Address& address);
         uint16_t readTwoBytes(const Address& address);
         Address readAddressAt(const Address& address);
-        void addCycles(int cycles);
+
+        /// @brief Let devices see elapsed CPU cycles.
+        /// @param cycles cycles taken by the CPU
+        /// @return cycles elapsed, including any the CPU was stalled for
+        int addCycles(int cycles);
+
+        /// @brief Hold the CPU off the bus, as a DMA transfer does.
+        /// @details
+        /// The cycles are passed to every device and added to the CPU's
+        /// count at the end of the current addCycles.
+        /// @param cycles cycles to stall for
+        void stall(int cycles) { mStallCycles += cycles; }
+
+        /// @brief Look up the host memory for some pages again.
+        /// @details
+        /// For devices whose page pointers change while running, such as
+        /// a window onto a disk image. The pages count as unwritten since
+        /// protectPages, so the observer sees the new memory's first write.
+        /// @param first first 24-bit address
+        /// @param size number of addresses
+        void remapPages(uint32_t first, uint32_t size);
+
+        /// @brief Watch for pages about to change; null to stop.
+        /// @param observer told about each page, once per protectPages
+        void setPageObserver(PageObserver* observer);
+
+        /// @brief Start a new interval in which the observer hears about
+        /// the first write to each page of memory.
+        /// @details
+        /// Writes to a page take the slow path until the first one, so
+        /// a page costs one call per interval.
+        void protectPages();
+
+        /// @brief Devices in priority order.
+        const std::vector<SystemBusDevice*>& devices() const { return mDevices; }
+
+        /// @brief Reads and writes that reached a device, rather than
+        /// memory the bus accesses directly.
+        /// @param index position of the device in devices()
+        uint64_t deviceReads(size_t index) const { return mDeviceAccesses[2 * index]; }
+        uint64_t deviceWrites(size_t index) const { return mDeviceAccesses[2 * index + 1]; }
+
+        /// @brief IRQ line driven by the devices.
+        InterruptLine& irq() { return mIrq; }
+
+        /// @brief Count of page mapping changes.
+        /// @details
+        /// Pointers from readPage and writePage stay valid while this is
+        /// unchanged, so callers may cache them.
+        uint32_t generation() const { return mGeneration; }
+
+        /// @brief Host memory holding a 256-byte page for reading.
+        /// @param absolute any 24-bit address in the page
+        /// @return pointer to the start of the page, or null if the page
+        /// must be accessed through its device
+        const uint8_t* readPage(uint32_t absolute) const { return mReadPages[(absolute >> 8) & 0xFFFF]; }
+
+        /// @brief Host memory holding a 256-byte page for writing.
+        /// @param absolute any 24-bit address in the page
+        /// @return pointer to the start of the page, or null if the page
+        /// must be accessed through its device
+        uint8_t* writePage(uint32_t absolute) const { return mWritePages[(absolute >> 8) & 0xFFFF]; }
+
+        // Pages backed directly by memory are accessed through host
+        // pointers; everything else goes to the owning device.
+        void storeByte(const Address& address, uint8_t value) {
+            const uint32_t absolute = address.getAbsolute();
+            uint8_t *page = mWritePages[absolute >> 8];
+            if (page) {
+                page[absolute & 0xFF] = value;
+            } else {
+                storeDeviceByte(address, value);
+            }
+        }
+
+        uint8_t readByte(const Address& address) {
+            const uint32_t absolute = address.getAbsolute();
+            const uint8_t *page = mReadPages[absolute >> 8];
+            if (page) {
+                return page[absolute & 0xFF];
+            }
+            return readDeviceByte(address);
+        }
+
+        /// @brief Read a byte without side effects, as a debugger does.
+        /// @param absolute 24-bit address
+        /// @return the byte, or -1 for device registers, which cannot be
+        /// read back without side effects
+        int peekByte(uint32_t absolute);
+
+        /// @brief Store a block of bytes.
+        /// @details
+        /// Runs within pages backed by memory are copied directly; other
+        /// pages are stored a byte at a time through their device.
+        /// @param first 24-bit address of the first byte
+        /// @param data bytes to store
+        /// @param size number of bytes, wrapping at the end of memory
+        void storeBytes(uint32_t first, const uint8_t* data, uint32_t size);
+
+        /// @brief Add a watchpoint.
+        /// @param first first address watched
+        /// @param last last address watched, inclusive
+        /// @param kinds WATCH_* flags
+        /// @return watchpoint id
+        int addWatchpoint(const Address& first, const Address& last, uint8_t kinds);
+
+        /// @brief Remove a watchpoint.
+        /// @param id watchpoint id returned by addWatchpoint
+        /// @return false if there was no such watchpoint
+        bool removeWatchpoint(int id);
+
+        /// @brief Watchpoints and their triggers.
+        Watchpoints& watchpoints() { return mWatchpoints; }
+
+        /// @brief Ask the code running the machine to stop after the
+        /// current instruction.
+        void requestStop() { mStopRequested = true; }
+
+        /// @brief Check for a stop request not yet taken.
+        bool stopRequested() const { return mStopRequested; }
+
+        /// @brief Forget any stop request.
+        void clearStopRequest() { mStopRequested = false; }
 
     private:
 
         std::vector<SystemBusDevice *> mDevices;
+
+        // Reads and writes of each device, in pairs.
+        CounterSlots mDeviceAccesses;
+
+        // Host memory for each 256-byte page, or null for pages that need
+        // the device to be called (I/O, partially mapped or watched pages).
+        std::vector<uint8_t *> mReadPages;
+        std::vector<uint8_t *> mWritePages;
+        // Bumped whenever either table changes.
+        uint32_t mGeneration = 0;
+
+        Watchpoints mWatchpoints;
+
+        InterruptLine mIrq;
+
+        // Stall requested by devices during the current addCycles.
+        int mStallCycles = 0;
+
+        // Observer of first writes, and the pages written since the last
+        // protectPages.
+        PageObserver* mPageObserver = nullptr;
+        std::vector<bool> mPageWritten;
+
+        // Set by requestStop until taken.
+        bool mStopRequested = false;
+
+        void mapPages();
+        void mapPage(uint32_t page);
+        SystemBusDevice* findDevice(const Address& address, Address& decodedAddress, size_t* index = nullptr);
+        void storeDeviceByte(const Address& address, uint8_t value);
+        uint8_t readDeviceByte(const Address& address);
+        int peekByte(SystemBusDevice* device, const Address& decodedAddress);
 };
 
 #endif // SYSTEM_BUS_HPP_INCLUDED
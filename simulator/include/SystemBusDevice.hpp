@@ -27,6 +27,9 @@
 #define HALF_BANK_SIZE_BYTES            0x8000
 #define PAGE_SIZE_BYTES                    256
 
+class DeviceState;
+class MetricsGroup;
+
 class Address {
     private:
         uint8_t mBank;
@@ -38,6 +41,13 @@ class Address {
         static Address sumOffsetToAddressNoWrapAround(const Address &, uint16_t);
         static Address sumOffsetToAddressWrapAround(const Address &, uint16_t);
 
+        /// @brief Parse a hex address written as BB:OOOO or as a plain
+        /// 24-bit value with an optional $ or 0x prefix.
+        /// @param text address text
+        /// @param out parsed address
+        /// @return false if the text is not a valid address
+        static bool parse(const char *text, Address &out);
+
         Address() = default;
         Address(uint8_t bank, uint16_t offset) : mBank(bank), mOffset(offset) {};
 
@@ -89,6 +99,38 @@ class SystemBusDevice {
         /// @brief Add clock cycles to the device's cycle count.
         /// @param cycles clock cycles
         virtual void addCycles(int cycles) {}
+
+        /// @brief Get the range of absolute addresses the device decodes.
+        /// @param first first 24-bit address
+        /// @param size number of addresses
+        /// @return false if the device cannot describe its range, in which
+        /// case the bus never maps memory around it directly
+        virtual bool getAddressRange(uint32_t& first, uint32_t& size) { return false; }
+
+        /// @brief Get host memory backing a whole 256-byte page.
+        /// @details
+        /// Devices that are plain memory return a pointer so the bus can
+        /// access the page directly instead of calling readByte/storeByte.
+        /// @param addr decoded address of the first byte of the page
+        /// @param write true if the page will be written through the pointer
+        /// @return pointer to the page, or null if the device must be called
+        virtual uint8_t* getPagePointer(const Address& addr, bool write) { return 0; }
+
+        /// @brief Save the device's registers for a checkpoint.
+        /// @details
+        /// Memory the device hands out through getPagePointer is saved by
+        /// the bus, so plain memory devices need not override this.
+        /// @param state state to append to
+        virtual void saveState(DeviceState& state) {}
+
+        /// @brief Put back registers saved by saveState.
+        /// @param state state to read from
+        virtual void restoreState(DeviceState& state) {}
+
+        /// @brief Name the kind of device and add its own counters to a
+        /// metrics export.
+        /// @param group values exported for the device
+        virtual void addMetrics(MetricsGroup& group) {}
 };
 
 #endif // SYSBUS_DEVICE_H
@@ -18,6 +18,8 @@
 #ifndef UART_HPP_INCLUDED
 #define UART_HPP_INCLUDED
 
+#include "InputLog.hpp"
+#include "Metrics.hpp"
 #include "SystemBusDevice.hpp"
 #include "Terminal.hpp"
 
@@ -35,7 +37,16 @@ public:
     void storeByte(const Address &addr, uint8_t val);
     uint8_t readByte(const Address &addr);
     bool decodeAddress(const Address &in, Address &out);
+    bool getAddressRange(uint32_t &first, uint32_t &size);
     void addCycles(int cycles);
+    void saveState(DeviceState &state);
+    void restoreState(DeviceState &state);
+    void addMetrics(MetricsGroup &group);
+
+    /// @brief Record the bytes received from the terminal in a log, or
+    /// when it is replaying, receive the bytes in the log instead.
+    /// @param log input log, or null for none
+    void setInputLog(InputLog *log) { mInput = log; }
 
 private:
     // Base address.
@@ -67,12 +78,21 @@ private:
     // Number of clock counts until the next character will go out.
     int mClocksUntilSend;
 
+    // Cycles since reset, the clock input bytes are logged against.
+    uint64_t mCycles;
+
     // Flag indicating the RBR has data.
     bool rbrFull;
 
     // Terminal (when connected to one).
     Terminal *mTerm;
 
+    // Input log (when recording or replaying).
+    InputLog *mInput;
+
+    // Bytes received and sent, and bytes lost to overruns.
+    CounterSlots mCounts;
+
     // Check if there are interrupts and trigger IRQ if appropriate.
     void checkForInterrupts();
     // Set the rate at which bytes will be sent.
@@ -0,0 +1,99 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef WATCHPOINTS_HPP_INCLUDED
+#define WATCHPOINTS_HPP_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Watchpoint kinds, OR'd together.
+#define WATCH_READ      1
+#define WATCH_WRITE     2
+#define WATCH_CHANGE    4
+
+/// @brief Memory watchpoints over address ranges.
+/// @details
+/// Watchpoints are tracked per 256-byte page. The system bus keeps watched
+/// pages off its direct memory path, so only accesses to those pages are
+/// checked here.
+class Watchpoints {
+public:
+    /// @brief One watchpoint trigger.
+    struct Hit {
+        uint32_t address;   ///< 24-bit address accessed
+        uint8_t kind;       ///< WATCH_READ, WATCH_WRITE or WATCH_CHANGE
+        int oldValue;       ///< value before a store, or -1 if unknown
+        uint8_t newValue;   ///< value read or stored
+    };
+
+    Watchpoints();
+
+    /// @brief Add a watchpoint.
+    /// @param first first 24-bit address
+    /// @param last last 24-bit address, inclusive
+    /// @param kinds WATCH_* flags
+    /// @return watchpoint id
+    int add(uint32_t first, uint32_t last, uint8_t kinds);
+
+    /// @brief Remove a watchpoint.
+    /// @param id watchpoint id returned by add
+    /// @return false if there was no such watchpoint
+    bool remove(int id);
+
+    /// @brief Watch kinds present anywhere in a page.
+    /// @param page page number (24-bit address >> 8)
+    uint8_t pageKinds(uint16_t page) const { return mPageKinds[page]; }
+
+    /// @brief Check a read from a watched page.
+    /// @param addr 24-bit address
+    /// @param value value read
+    void checkRead(uint32_t addr, uint8_t value);
+
+    /// @brief Check a store to a watched page.
+    /// @param addr 24-bit address
+    /// @param oldValue previous value, or -1 if it cannot be read back
+    /// @param newValue value stored
+    void checkWrite(uint32_t addr, int oldValue, uint8_t newValue);
+
+    /// @brief Check for triggers not yet taken.
+    bool hasHits() const { return !mHits.empty(); }
+
+    /// @brief Triggers since the last clearHits.
+    const std::vector<Hit> &hits() const { return mHits; }
+
+    /// @brief Forget all triggers.
+    void clearHits() { mHits.clear(); }
+
+private:
+    struct Watch {
+        uint32_t first;
+        uint32_t last;
+        uint8_t kinds;
+    };
+
+    std::map<int, Watch> mWatches;
+    std::vector<uint8_t> mPageKinds;
+    std::vector<Hit> mHits;
+    int mNextId;
+
+    // Recompute page kinds for the pages covering a range.
+    void updatePages(uint32_t first, uint32_t last);
+};
+
+#endif // WATCHPOINTS_HPP_INCLUDED
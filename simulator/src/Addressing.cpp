@@ -23,48 +23,10 @@
 
 #define LOG_TAG "Addressing"
 
-bool Cpu65816::opCodeAddressingCrossesPageBoundary(OpCode &opCode) {
-    switch(opCode.getAddressingMode()) {
-        case AddressingMode::AbsoluteIndexedWithX:
-        {
-            Address initialAddress(mDB, mSystemBus.readTwoBytes(mProgramAddress.newWithOffset(1)));
-            // TODO: figure out when to wrap around and when not to, it should not matter in this case
-            // but it matters when fetching data
-            Address finalAddress = Address::sumOffsetToAddress(initialAddress, indexWithXRegister());
-            return Address::offsetsAreOnDifferentPages(initialAddress.getOffset(), finalAddress.getOffset());
-        }
-        case AddressingMode::AbsoluteIndexedWithY:
-        {
-            Address initialAddress(mDB, mSystemBus.readTwoBytes(mProgramAddress.newWithOffset(1)));
-            // TODO: figure out when to wrap around and when not to, it should not matter in this case
-            // but it matters when fetching data
-            Address finalAddress = Address::sumOffsetToAddress(initialAddress, indexWithYRegister());
-            return Address::offsetsAreOnDifferentPages(initialAddress.getOffset(), finalAddress.getOffset());
-        }
-        case AddressingMode::DirectPageIndirectIndexedWithY:
-        {
-            uint16_t firstStageOffset = mD + mSystemBus.readByte(mProgramAddress.newWithOffset(1));
-            Address firstStageAddress(0x00, firstStageOffset);
-            uint16_t secondStageOffset = mSystemBus.readTwoBytes(firstStageAddress);
-            Address thirdStageAddress(mDB, secondStageOffset);
-            // TODO: figure out when to wrap around and when not to, it should not matter in this case
-            // but it matters when fetching data
-            Address finalAddress = Address::sumOffsetToAddress(thirdStageAddress, indexWithYRegister());
-            return Address::offsetsAreOnDifferentPages(thirdStageAddress.getOffset(), finalAddress.getOffset());
-        }
-        default:
-        {
-            Log::err(LOG_TAG).str("!!! Unsupported opCodeAddressingCrossesPageBoundary for opCode: ").hex(opCode.getCode(), 2).show();
-        }
-
-    }
-
-    return false;
-}
-
-Address Cpu65816::getAddressOfOpCodeData(OpCode &opCode) {
-    uint8_t dataAddressBank;
-    uint16_t dataAddressOffset;
+void Cpu65816::resolveOperand(OpCode &opCode) {
+    uint8_t dataAddressBank = 0;
+    uint16_t dataAddressOffset = 0;
+    bool crossesPage = false;
 
     switch(opCode.getAddressingMode()) {
         case AddressingMode::Interrupt:
@@ -72,7 +34,8 @@ Address Cpu65816::getAddressOfOpCodeData(OpCode &opCode) {
         case AddressingMode::Implied:
         case AddressingMode::StackImplied:
             // Not really used, doesn't make any sense since these opcodes do not have operands
-            return mProgramAddress;
+            mProgramAddress.getBankAndOffset(&dataAddressBank, &dataAddressOffset);
+            break;
         case AddressingMode::Immediate:
         case AddressingMode::BlockMove:
             // Blockmove OpCodes have two bytes following them directly
@@ -118,7 +81,8 @@ Address Cpu65816::getAddressOfOpCodeData(OpCode &opCode) {
         {
             Address firstStageAddress(mDB, mSystemBus.readTwoBytes(mProgramAddress.newWithOffset(1)));
             Address::sumOffsetToAddressNoWrapAround(firstStageAddress, indexWithXRegister())
-                .getBankAndOffset(&dataAddressBank, &dataAddressOffset);;
+                .getBankAndOffset(&dataAddressBank, &dataAddressOffset);
+            crossesPage = Address::offsetsAreOnDifferentPages(firstStageAddress.getOffset(), dataAddressOffset);
         }
             break;
         case AddressingMode::AbsoluteLongIndexedWithX:
@@ -132,7 +96,8 @@ Address Cpu65816::getAddressOfOpCodeData(OpCode &opCode) {
         {
             Address firstStageAddress(mDB, mSystemBus.readTwoBytes(mProgramAddress.newWithOffset(1)));
             Address::sumOffsetToAddressNoWrapAround(firstStageAddress, indexWithYRegister())
-                .getBankAndOffset(&dataAddressBank, &dataAddressOffset);;
+                .getBankAndOffset(&dataAddressBank, &dataAddressOffset);
+            crossesPage = Address::offsetsAreOnDifferentPages(firstStageAddress.getOffset(), dataAddressOffset);
         }
             break;
         case AddressingMode::DirectPage:
@@ -188,6 +153,7 @@ Address Cpu65816::getAddressOfOpCodeData(OpCode &opCode) {
             Address thirdStageAddress(mDB, secondStageOffset);
             Address::sumOffsetToAddressNoWrapAround(thirdStageAddress, indexWithYRegister())
                 .getBankAndOffset(&dataAddressBank, &dataAddressOffset);
+            crossesPage = Address::offsetsAreOnDifferentPages(secondStageOffset, dataAddressOffset);
         }
             break;
         case AddressingMode::DirectPageIndirectLongIndexedWithY:
@@ -221,5 +187,7 @@ Address Cpu65816::getAddressOfOpCodeData(OpCode &opCode) {
             break;
     }
 
-    return Address(dataAddressBank, dataAddressOffset);
+    mOperand.address = Address(dataAddressBank, dataAddressOffset);
+    mOperand.crossesPage = crossesPage;
+    mOperand.resolved = true;
 }
@@ -0,0 +1,272 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "BlockDevice.hpp"
+#include "DeviceState.hpp"
+#include "Log.hpp"
+#include "Metrics.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define LOG_TAG "BlockDevice"
+
+// Bytes of address space: registers, then the window.
+#define DISK_SIZE 0x400
+
+// Cycles between batched flushes, a second at 8 MHz.
+#define FLUSH_CYCLES 8000000
+
+namespace {
+
+size_t hostPageSize() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+} // namespace
+
+BlockDevice::BlockDevice(const Address &baseAddr, SystemBus &bus) : mBase(baseAddr.getAbsolute()),
+                                                                    mBus(bus),
+                                                                    mImage(0),
+                                                                    mImageSize(0),
+                                                                    mSectors(0),
+                                                                    mWritable(false),
+                                                                    mLba(0),
+                                                                    mStatus(0),
+                                                                    mWindow(0),
+                                                                    mDirtyFirst(0),
+                                                                    mDirtyLast(0),
+                                                                    mDirty(false),
+                                                                    mCyclesUntilFlush(FLUSH_CYCLES) {
+}
+
+BlockDevice::~BlockDevice() {
+    detach();
+}
+
+bool BlockDevice::attach(const std::string &filename, std::string &error) {
+    detach();
+    error = "cannot map " + filename;
+#if defined(_WIN32)
+    mWritable = true;
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        mWritable = false;
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    mImageSize = (size_t)size.QuadPart;
+    if (mImageSize >= DISK_SECTOR_SIZE) {
+        // The view keeps the mapping open after the handles are closed.
+        HANDLE mapping = CreateFileMappingA(file, NULL, mWritable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            mImage = (uint8_t *)MapViewOfFile(mapping, mWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    mWritable = true;
+    int fd = ::open(filename.c_str(), O_RDWR);
+    if (fd < 0) {
+        mWritable = false;
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        return false;
+    }
+    mImageSize = (size_t)status.st_size;
+    if (mImageSize >= DISK_SECTOR_SIZE) {
+        void *view = mmap(0, mImageSize, mWritable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (view != MAP_FAILED) mImage = (uint8_t *)view;
+    }
+    close(fd);
+#endif
+    if (mImageSize < DISK_SECTOR_SIZE) {
+        error = filename + " is smaller than one sector";
+        mImageSize = 0;
+        return false;
+    }
+    if (!mImage) return false;
+
+    const uint64_t sectors = mImageSize / DISK_SECTOR_SIZE;
+    mSectors = sectors > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)sectors;
+    mStatus = DISK_READY | (mWritable ? 0 : DISK_WRITE_PROTECT);
+    Log::vrb(LOG_TAG).str("Attached ").str(filename.c_str()).str(" with ").hex(mSectors).str(" sectors").show();
+    error.clear();
+    select();
+    return true;
+}
+
+void BlockDevice::storeByte(const Address &addr, uint8_t val) {
+    const uint16_t reg = addr.getOffset();
+    if (reg >= DISK_WINDOW) {
+        if (mWindow && mWritable) {
+            mWindow[reg - DISK_WINDOW] = val;
+            markDirty(mLba);
+        }
+    } else if (reg < DISK_LBA + 4) {
+        const int shift = 8 * (reg - DISK_LBA);
+        mLba = (mLba & ~((uint32_t)0xFF << shift)) | ((uint32_t)val << shift);
+    } else if (reg == DISK_COMMAND) {
+        switch (val) {
+            case DISK_SELECT:
+                select();
+                break;
+            case DISK_FLUSH:
+                flush(true);
+                break;
+            default:
+                Log::trc(LOG_TAG).str("Ignoring command ").hex(val, 2).show();
+                break;
+        }
+    }
+}
+
+uint8_t BlockDevice::readByte(const Address &addr) {
+    const uint16_t reg = addr.getOffset();
+    if (reg >= DISK_WINDOW) return mWindow ? mWindow[reg - DISK_WINDOW] : 0xFF;
+    if (reg < DISK_LBA + 4) return (uint8_t)(mLba >> (8 * (reg - DISK_LBA)));
+    if (reg == DISK_STATUS) return mStatus;
+    if (reg >= DISK_SECTORS && reg < DISK_SECTORS + 4) return (uint8_t)(mSectors >> (8 * (reg - DISK_SECTORS)));
+    return 0;
+}
+
+bool BlockDevice::decodeAddress(const Address &in, Address &out) {
+    uint32_t addr = in.getAbsolute() - mBase;
+    out = Address((addr >> 16) & 0xFF, addr & 0xFFFF);
+    return addr < DISK_SIZE;
+}
+
+bool BlockDevice::getAddressRange(uint32_t &first, uint32_t &size) {
+    first = mBase;
+    size = DISK_SIZE;
+    return true;
+}
+
+void BlockDevice::addCycles(int cycles) {
+    if (!mDirty) return;
+    mCyclesUntilFlush -= cycles;
+    if (mCyclesUntilFlush <= 0) flush(false);
+}
+
+uint8_t *BlockDevice::getPagePointer(const Address &addr, bool write) {
+    if (!mWindow || addr.getOffset() < DISK_WINDOW || (write && !mWritable)) return 0;
+    return mWindow + (addr.getOffset() - DISK_WINDOW);
+}
+
+void BlockDevice::saveState(DeviceState &state) {
+    state.put(mLba);
+    state.put(mWindow ? (uint32_t)((mWindow - mImage) / DISK_SECTOR_SIZE) : 0xFFFFFFFF);
+    state.put(mStatus);
+}
+
+void BlockDevice::restoreState(DeviceState &state) {
+    // Select the sector that was in the window, then put back the LBA
+    // register, which may have been rewritten since.
+    const uint32_t lba = state.get<uint32_t>();
+    mLba = state.get<uint32_t>();
+    const uint8_t status = state.get<uint8_t>();
+    select();
+    mLba = lba;
+    mStatus = status;
+}
+
+void BlockDevice::addMetrics(MetricsGroup &group) {
+    group.setKind("disk");
+}
+
+void BlockDevice::flush(bool wait) {
+    mCyclesUntilFlush = FLUSH_CYCLES;
+    if (!mDirty) return;
+    mDirty = false;
+
+    // Both calls need the start of a host page.
+    const size_t pageSize = hostPageSize();
+    const size_t first = (size_t)mDirtyFirst * DISK_SECTOR_SIZE / pageSize * pageSize;
+    const size_t end = ((size_t)mDirtyLast + 1) * DISK_SECTOR_SIZE;
+#if defined(_WIN32)
+    (void)wait;
+    FlushViewOfFile(mImage + first, end - first);
+#else
+    msync(mImage + first, end - first, wait ? MS_SYNC : MS_ASYNC);
+#endif
+
+    // The sector in the window can still change.
+    if (mWindow && mWritable) markDirty(mLba);
+}
+
+void BlockDevice::select() {
+    if (mImage && mLba < mSectors) {
+        mWindow = mImage + (size_t)mLba * DISK_SECTOR_SIZE;
+        mStatus &= ~DISK_ERROR;
+        if (mWritable) markDirty(mLba);
+    } else {
+        mWindow = 0;
+        if (mImage) mStatus |= DISK_ERROR;
+    }
+    mBus.remapPages(mBase + DISK_WINDOW, DISK_SECTOR_SIZE);
+}
+
+void BlockDevice::markDirty(uint32_t sector) {
+    if (!mDirty) {
+        mDirtyFirst = mDirtyLast = sector;
+        mDirty = true;
+    } else if (sector < mDirtyFirst) {
+        mDirtyFirst = sector;
+    } else if (sector > mDirtyLast) {
+        mDirtyLast = sector;
+    }
+}
+
+void BlockDevice::detach() {
+    if (!mImage) return;
+    flush(true);
+#if defined(_WIN32)
+    UnmapViewOfFile(mImage);
+#else
+    munmap(mImage, mImageSize);
+#endif
+    mImage = 0;
+    mImageSize = 0;
+    mSectors = 0;
+    mWindow = 0;
+    mStatus = 0;
+}
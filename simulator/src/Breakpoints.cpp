@@ -0,0 +1,100 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Breakpoints.hpp"
+
+// Number of 256-byte pages in the 24-bit address space.
+#define PAGE_COUNT 0x10000
+
+BreakpointSet::BreakpointSet() : mPages(PAGE_COUNT, nullptr) {
+}
+
+void BreakpointSet::add(const Address &addr, bool temporary, uint32_t ignoreCount) {
+    const uint32_t absolute = addr.getAbsolute();
+    mBreakpoints[absolute] = Breakpoint { temporary, ignoreCount, 0 };
+    setBit(absolute);
+}
+
+bool BreakpointSet::remove(const Address &addr) {
+    const uint32_t absolute = addr.getAbsolute();
+    if (mBreakpoints.erase(absolute) == 0) return false;
+    clearBit(absolute);
+    return true;
+}
+
+void BreakpointSet::clear() {
+    mBreakpoints.clear();
+    mPageBits.clear();
+    mPages.assign(PAGE_COUNT, nullptr);
+}
+
+bool BreakpointSet::anyInRange(uint32_t first, uint32_t last) const {
+    if (first > last) return false;
+    for (uint32_t page = first >> 8; page <= (last >> 8); ++page) {
+        if (mPages[page]) {
+            auto it = mBreakpoints.lower_bound(first);
+            return it != mBreakpoints.end() && it->first <= last;
+        }
+    }
+    return false;
+}
+
+bool BreakpointSet::hit(uint32_t addr) {
+    auto it = mBreakpoints.find(addr);
+    if (it == mBreakpoints.end()) return false;
+
+    Breakpoint &bp = it->second;
+    ++bp.hits;
+    if (bp.ignoreCount > 0) {
+        --bp.ignoreCount;
+        return false;
+    }
+    if (bp.temporary) {
+        mBreakpoints.erase(it);
+        clearBit(addr);
+    }
+    return true;
+}
+
+uint32_t BreakpointSet::hitCount(const Address &addr) const {
+    auto it = mBreakpoints.find(addr.getAbsolute());
+    return it == mBreakpoints.end() ? 0 : it->second.hits;
+}
+
+void BreakpointSet::setBit(uint32_t addr) {
+    const uint16_t page = (addr >> 8) & 0xFFFF;
+    if (!mPages[page]) {
+        std::unique_ptr<uint64_t[]> &bits = mPageBits[page];
+        bits.reset(new uint64_t[4]());
+        mPages[page] = bits.get();
+    }
+    mPages[page][(addr >> 6) & 3] |= (uint64_t)1 << (addr & 63);
+}
+
+void BreakpointSet::clearBit(uint32_t addr) {
+    const uint16_t page = (addr >> 8) & 0xFFFF;
+    uint64_t *bits = mPages[page];
+    if (!bits) return;
+    bits[(addr >> 6) & 3] &= ~((uint64_t)1 << (addr & 63));
+
+    // Release the page once its last breakpoint is gone, so execution in
+    // it goes back to the null page check.
+    if ((bits[0] | bits[1] | bits[2] | bits[3]) == 0) {
+        mPages[page] = nullptr;
+        mPageBits.erase(page);
+    }
+}
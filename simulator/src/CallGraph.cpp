@@ -0,0 +1,136 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "CallGraph.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+// Parent of the root nodes.
+#define NO_NODE 0xFFFFFFFF
+
+// Stack pointer recorded for a root frame, which no return pops.
+#define ROOT_STACK_POINTER 0x10000
+
+CallGraph::CallGraph() : mLastCycles(0) {
+}
+
+void CallGraph::start(uint32_t addr, uint64_t cycles) {
+    update(cycles);
+    mFrames.clear();
+    mFrames.push_back(Frame { child(NO_NODE, addr), ROOT_STACK_POINTER });
+    mLastCycles = cycles;
+}
+
+void CallGraph::enter(uint32_t addr, uint16_t stackPointer, uint64_t cycles) {
+    update(cycles);
+
+    // A caller always runs below the stack pointer of its own entry, so
+    // frames at or below this one were abandoned without a return.
+    while (mFrames.size() > 1 && mFrames.back().stackPointer <= stackPointer) {
+        mFrames.pop_back();
+    }
+    const uint32_t node = child(mFrames.back().node, addr);
+    ++mNodes[node].calls;
+    mFrames.push_back(Frame { node, stackPointer });
+}
+
+void CallGraph::leave(uint16_t stackPointer, uint64_t cycles) {
+    update(cycles);
+    while (mFrames.size() > 1 && mFrames.back().stackPointer < stackPointer) {
+        mFrames.pop_back();
+    }
+}
+
+void CallGraph::update(uint64_t cycles) {
+    if (!mFrames.empty()) mNodes[mFrames.back().node].cycles += cycles - mLastCycles;
+    mLastCycles = cycles;
+}
+
+uint32_t CallGraph::child(uint32_t parent, uint32_t addr) {
+    auto inserted = mChildren.insert(std::make_pair(std::make_pair(parent, addr), (uint32_t)mNodes.size()));
+    if (inserted.second) mNodes.push_back(Node { addr, parent, 0, 0 });
+    return inserted.first->second;
+}
+
+std::string CallGraph::path(uint32_t node, const Symbols &symbols) const {
+    std::string result = symbols.describe(mNodes[node].address);
+    for (uint32_t parent = mNodes[node].parent; parent != NO_NODE; parent = mNodes[parent].parent) {
+        result = symbols.describe(mNodes[parent].address) + ";" + result;
+    }
+    return result;
+}
+
+void CallGraph::writeCollapsed(std::ostream &out, const Symbols &symbols) const {
+    for (uint32_t node = 0; node < mNodes.size(); ++node) {
+        if (mNodes[node].cycles == 0) continue;
+        out << path(node, symbols) << " " << mNodes[node].cycles << std::endl;
+    }
+}
+
+void CallGraph::report(std::ostream &out, const Symbols &symbols, size_t limit) const {
+    // Children always come after their parent, so a reverse pass sums
+    // the cycles of each subtree.
+    std::vector<uint64_t> subtree(mNodes.size());
+    for (size_t node = mNodes.size(); node-- > 0;) {
+        subtree[node] += mNodes[node].cycles;
+        if (mNodes[node].parent != NO_NODE) subtree[mNodes[node].parent] += subtree[node];
+    }
+
+    struct Routine {
+        uint32_t address;
+        uint64_t inclusive;
+        uint64_t exclusive;
+        uint64_t calls;
+    };
+    std::map<uint32_t, Routine> routines;
+    uint64_t total = 0;
+    for (uint32_t node = 0; node < mNodes.size(); ++node) {
+        const uint32_t address = mNodes[node].address;
+        Routine &routine = routines[address];
+        routine.address = address;
+        routine.exclusive += mNodes[node].cycles;
+        total += mNodes[node].cycles;
+
+        // Recursive calls are already inside the outer call's time.
+        bool recursive = false;
+        for (uint32_t parent = mNodes[node].parent; parent != NO_NODE && !recursive; parent = mNodes[parent].parent) {
+            recursive = mNodes[parent].address == address;
+        }
+        if (!recursive) routine.inclusive += subtree[node];
+        routine.calls += mNodes[node].calls;
+    }
+
+    std::vector<Routine> lines;
+    for (const auto &entry : routines) lines.push_back(entry.second);
+    std::sort(lines.begin(), lines.end(),
+        [](const Routine &a, const Routine &b) { return a.inclusive > b.inclusive; });
+
+    out << "Call graph:" << std::endl;
+    out << std::setw(14) << "inclusive" << std::setw(8) << "%"
+        << std::setw(14) << "exclusive" << std::setw(8) << "%"
+        << std::setw(10) << "calls" << "  routine" << std::endl;
+    for (size_t i = 0; i < lines.size() && i < limit; ++i) {
+        const Routine &line = lines[i];
+        out << std::fixed << std::setprecision(2)
+            << std::setw(14) << line.inclusive << std::setw(8) << (total ? 100.0 * line.inclusive / total : 0.0)
+            << std::setw(14) << line.exclusive << std::setw(8) << (total ? 100.0 * line.exclusive / total : 0.0)
+            << std::setw(10) << line.calls << "  " << symbols.describe(line.address) << std::endl;
+    }
+    out << std::endl;
+}
@@ -0,0 +1,171 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Coverage.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+// 64-bit words in the map, one bit per address.
+#define WORD_COUNT 0x40000
+
+// Words in one 256-byte page.
+#define PAGE_WORDS 4
+
+// First bytes of a saved map. Each page with bits set follows as a
+// 16-bit page number and 32 bytes of bits, all little-endian.
+#define FILE_MAGIC "DT65COV1"
+#define FILE_MAGIC_LENGTH 8
+
+namespace {
+
+bool isHexField(const std::string &s, size_t pos, size_t length) {
+    if (s.size() < pos + length) return false;
+    for (size_t i = pos; i < pos + length; ++i) {
+        if (!isxdigit((unsigned char)s[i])) return false;
+    }
+    return true;
+}
+
+struct ListingLine {
+    std::string text;
+    bool code;
+    uint32_t address;
+};
+
+struct LabelCoverage {
+    std::string name;
+    size_t lines;
+    size_t covered;
+};
+
+} // namespace
+
+Coverage::Coverage() : mBits(WORD_COUNT, 0) {
+}
+
+void Coverage::merge(const Coverage &other) {
+    for (size_t i = 0; i < WORD_COUNT; ++i) {
+        mBits[i] |= other.mBits[i];
+    }
+}
+
+bool Coverage::load(const std::string &filename) {
+    std::ifstream infile(filename, std::ios_base::binary);
+    if (!infile) return false;
+
+    char magic[FILE_MAGIC_LENGTH];
+    if (!infile.read(magic, FILE_MAGIC_LENGTH) || std::string(magic, FILE_MAGIC_LENGTH) != FILE_MAGIC) return false;
+
+    unsigned char record[2 + PAGE_WORDS * 8];
+    while (infile.read((char *)record, sizeof(record))) {
+        const uint32_t page = record[0] | (record[1] << 8);
+        for (int word = 0; word < PAGE_WORDS; ++word) {
+            uint64_t bits = 0;
+            for (int byte = 7; byte >= 0; --byte) {
+                bits = (bits << 8) | record[2 + word * 8 + byte];
+            }
+            mBits[page * PAGE_WORDS + word] |= bits;
+        }
+    }
+    return infile.eof() && infile.gcount() == 0;
+}
+
+bool Coverage::save(const std::string &filename) const {
+    std::ofstream outfile(filename, std::ios_base::binary);
+    if (!outfile) return false;
+
+    outfile.write(FILE_MAGIC, FILE_MAGIC_LENGTH);
+    unsigned char record[2 + PAGE_WORDS * 8];
+    for (uint32_t page = 0; page < WORD_COUNT / PAGE_WORDS; ++page) {
+        const uint64_t *words = &mBits[page * PAGE_WORDS];
+        if ((words[0] | words[1] | words[2] | words[3]) == 0) continue;
+        record[0] = page & 0xFF;
+        record[1] = page >> 8;
+        for (int word = 0; word < PAGE_WORDS; ++word) {
+            for (int byte = 0; byte < 8; ++byte) {
+                record[2 + word * 8 + byte] = (words[word] >> (byte * 8)) & 0xFF;
+            }
+        }
+        outfile.write((const char *)record, sizeof(record));
+    }
+    return (bool)outfile;
+}
+
+bool Coverage::report(std::ostream &out, const std::string &listing) const {
+    std::ifstream infile(listing);
+    if (!infile) return false;
+
+    // Listing lines start with the six-digit address, a relocation flag
+    // and the include depth. Code bytes start in column 11 and source
+    // text in column 24. Lines with bytes from a directive are data.
+    std::vector<ListingLine> lines;
+    std::vector<LabelCoverage> labels(1, LabelCoverage { "(start)", 0, 0 });
+    std::string text;
+    while (std::getline(infile, text)) {
+        ListingLine line { text, false, 0 };
+        if (isHexField(text, 0, 6)) {
+            line.address = strtoul(text.substr(0, 6).c_str(), 0, 16);
+            const size_t source = text.size() > 24 ? text.find_first_not_of(" \t", 24) : std::string::npos;
+
+            // Start a new label section at each label or procedure.
+            if (source != std::string::npos && text[source] != '.' && text[source] != ';') {
+                const size_t colon = text.find(':', source);
+                const size_t space = text.find_first_of(" \t;", source);
+                if (colon != std::string::npos && colon < space && colon > source) {
+                    labels.push_back(LabelCoverage { text.substr(source, colon - source), 0, 0 });
+                }
+            } else if (source != std::string::npos && text.compare(source, 6, ".proc ") == 0) {
+                const size_t name = text.find_first_not_of(" \t", source + 6);
+                const size_t end = text.find_first_of(" \t;", name);
+                if (name != std::string::npos) labels.push_back(LabelCoverage { text.substr(name, end - name), 0, 0 });
+            }
+
+            const bool directive = source != std::string::npos && text[source] == '.';
+            if (isHexField(text, 11, 2) && !directive) {
+                line.code = true;
+                ++labels.back().lines;
+                if (covered(line.address)) ++labels.back().covered;
+            }
+        }
+        lines.push_back(line);
+    }
+
+    size_t total = 0;
+    size_t executed = 0;
+    for (const LabelCoverage &label : labels) {
+        total += label.lines;
+        executed += label.covered;
+    }
+    out << "Covered " << executed << " of " << total << " code lines ("
+        << std::fixed << std::setprecision(1) << (total ? 100.0 * executed / total : 0.0) << "%)"
+        << std::endl << std::endl;
+
+    out << "Labels with code never executed:" << std::endl;
+    for (const LabelCoverage &label : labels) {
+        if (label.covered == label.lines) continue;
+        out << std::setw(6) << label.covered << " /" << std::setw(6) << label.lines << "  " << label.name << std::endl;
+    }
+    out << std::endl;
+
+    for (const ListingLine &line : lines) {
+        out << (line.code ? (covered(line.address) ? '+' : '-') : ' ') << ' ' << line.text << std::endl;
+    }
+    return true;
+}
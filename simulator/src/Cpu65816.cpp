@@ -66,6 +66,60 @@ CpuStatus *Cpu65816::getCpuStatus() {
     return &mCpuStatus;
 }
 
+Cpu65816::Registers Cpu65816::getRegisters() {
+    Registers registers;
+    registers.a = mA;
+    registers.x = mX;
+    registers.y = mY;
+    registers.s = mStack.getStackPointer();
+    registers.d = mD;
+    registers.pc = mProgramAddress.getOffset();
+    registers.p = mCpuStatus.getRegisterValue();
+    registers.dbr = mDB;
+    registers.pbr = mProgramAddress.getBank();
+    registers.e = mCpuStatus.emulationFlag();
+    return registers;
+}
+
+void Cpu65816::setRegisters(const Registers &registers) {
+    // The emulation flag decides how the status bits are read.
+    if (registers.e) mCpuStatus.setEmulationFlag();
+    else mCpuStatus.clearEmulationFlag();
+    mCpuStatus.setRegisterValue(registers.p);
+    if (registers.e) {
+        mCpuStatus.setAccumulatorWidthFlag();
+        mCpuStatus.setIndexWidthFlag();
+    }
+    mA = registers.a;
+    mX = registers.x;
+    mY = registers.y;
+    mD = registers.d;
+    mDB = registers.dbr;
+    mStack.setStackPointer(registers.s);
+    mProgramAddress = Address(registers.pbr, registers.pc);
+}
+
+Cpu65816::Snapshot Cpu65816::getSnapshot() {
+    return Snapshot { getRegisters(), mPins.RES, mTotalCyclesCounter, mInstructionCounter };
+}
+
+void Cpu65816::restoreSnapshot(const Snapshot &snapshot) {
+    setRegisters(snapshot.registers);
+    mPins.RES = snapshot.stopped;
+    mTotalCyclesCounter = snapshot.cycles;
+    mInstructionCounter = snapshot.instructions;
+}
+
+void Cpu65816::setCallGraph(CallGraph *callGraph) {
+    mCallGraph = callGraph;
+    if (mCallGraph) mCallGraph->start(mProgramAddress.getAbsolute(), mTotalCyclesCounter);
+}
+
+void Cpu65816::setSampler(Sampler *sampler) {
+    mSampler = sampler;
+    mSampleDeadline = mSampler ? mSampler->start(mProgramAddress.getAbsolute(), mTotalCyclesCounter) : UINT64_MAX;
+}
+
 /**
  * Resets the cpu to its initial state.
  * */
@@ -79,6 +133,8 @@ void Cpu65816::reset() {
     mD = 0x0;
     mStack = Stack(&mSystemBus);
     mProgramAddress = Address(0x00, mSystemBus.readTwoBytes(Address(0x00, ERES)));
+    if (mCallGraph) mCallGraph->start(mProgramAddress.getAbsolute(), mTotalCyclesCounter);
+    if (mSampler) mSampleDeadline = mSampler->start(mProgramAddress.getAbsolute(), mTotalCyclesCounter);
 }
 
 void Cpu65816::setRESPin(bool value) {
@@ -96,7 +152,7 @@ bool Cpu65816::executeNextInstruction() {
     if (mPins.RES) {
         return false;
     }
-    if ((mPins.IRQ) && (!mCpuStatus.interruptDisableFlag())) {
+    if ((mPins.IRQ || mSystemBus.irq().asserted()) && (!mCpuStatus.interruptDisableFlag())) {
         /*
         The program bank register (PB, the A16-A23 part of the address bus) is pushed onto the hardware stack (65C816/65C802 only when operating in native mode).
         The most significant byte (MSB) of the program counter (PC) is pushed onto the stack.
@@ -118,13 +174,31 @@ bool Cpu65816::executeNextInstruction() {
         mCpuStatus.setInterruptDisableFlag();
         mCpuStatus.clearDecimalFlag();
         mProgramAddress = Address(0x00, mSystemBus.readTwoBytes(vectorAddress));
+        ++mInterruptCounter;
+        traceCall();
     }
 
     // Fetch the instruction
     const uint8_t instruction = mSystemBus.readByte(mProgramAddress);
     OpCode opCode = OP_CODE_TABLE[instruction];
+    mOperand.resolved = false;
+    ++mInstructionCounter;
+    if (mCoverage) mCoverage->mark(mProgramAddress.getAbsolute());
     // Execute it
-    return opCode.execute(*this);
+    bool result;
+    if (mProfiler) {
+        const uint32_t address = mProgramAddress.getAbsolute();
+        const uint64_t cycles = mTotalCyclesCounter;
+        result = opCode.execute(*this);
+        mProfiler->record(address, (uint32_t)(mTotalCyclesCounter - cycles));
+    } else {
+        result = opCode.execute(*this);
+    }
+    // The deadline stays at the maximum while there is no sampler.
+    if (mTotalCyclesCounter >= mSampleDeadline) {
+        mSampleDeadline = mSampler->sample(mProgramAddress.getAbsolute(), mTotalCyclesCounter);
+    }
+    return result;
 }
 
 bool Cpu65816::accumulatorIs8BitWide() {
@@ -150,8 +224,7 @@ bool Cpu65816::indexIs16BitWide() {
 }
 
 void Cpu65816::addToCycles(int cycles) {
-    mTotalCyclesCounter += cycles;
-    mSystemBus.addCycles(cycles);
+    mTotalCyclesCounter += mSystemBus.addCycles(cycles);
 }
 
 void Cpu65816::subtractFromCycles(int cycles) {
@@ -20,10 +20,16 @@
 
 #include "Cpu65816Debugger.hpp"
 #include "Cpu65816.hpp"
+#include "Disassembler.hpp"
 
 #define LOG_TAG "Cpu65816Debugger"
 
-Cpu65816Debugger::Cpu65816Debugger(Cpu65816 &cpu) : mCpu(cpu) {
+Cpu65816Debugger::Cpu65816Debugger(Cpu65816 &cpu) : Cpu65816Debugger(cpu, mOwnBreakPoints) {
+}
+
+Cpu65816Debugger::Cpu65816Debugger(Cpu65816 &cpu, BreakpointSet &breakPoints) :
+        mBreakPoints(breakPoints),
+        mCpu(cpu) {
     cpu.setRESPin(false);
 
     Log::dbg(LOG_TAG).str("Cpu is ready to run").show();
@@ -32,25 +38,30 @@ Cpu65816Debugger::Cpu65816Debugger(Cpu65816 &cpu) : mCpu(cpu) {
 void Cpu65816Debugger::step() {
     if (mBreakpointHit) return;
 
-    mOnBeforeStepHandler();
-    const uint8_t instruction = mCpu.mSystemBus.readByte(mCpu.mProgramAddress);
-    OpCode opCode = mCpu.OP_CODE_TABLE[instruction];
-    if (opCode.getCode() == 0xDB) {
-        mOnStpHandler();
-    }
-    logOpCode(opCode);
+    FunctionHooks hooks { *this };
+    StopReason reason;
+    stepWith(hooks, reason);
+}
 
-    mCpu.executeNextInstruction();
+void Cpu65816Debugger::logNextOpCode() const {
+    // Peeked like the operand bytes in logOpCode, so the instruction is
+    // fetched on the bus only once, when it executes.
+    const int instruction = mCpu.mSystemBus.peekByte(mCpu.mProgramAddress.getAbsolute());
+    OpCode opCode = mCpu.OP_CODE_TABLE[instruction < 0 ? 0 : instruction];
+    logOpCode(opCode);
+}
 
-    mOnAfterStepHandler();
+void Cpu65816Debugger::logBreakPoint() const {
+    Log::dbg(LOG_TAG).str("BREAKPOINT").sp()
+            .hex(mCpu.mProgramAddress.getBank(), 2).hex(mCpu.mProgramAddress.getOffset(), 4).show();
+}
 
-    if (mCpu.mProgramAddress.getBank() == mBreakPointAddress.getBank() &&
-        mCpu.mProgramAddress.getOffset() == mBreakPointAddress.getOffset()) {
-        mBreakpointHit = true;
-        Log::dbg(LOG_TAG).str("BREAKPOINT").sp()
-                .hex(mBreakPointAddress.getBank(), 2).hex(mBreakPointAddress.getOffset(), 4).show();
-        mOnBreakPointHandler();
+void Cpu65816Debugger::logWatchHits(const Address &instructionAddress) {
+    Watchpoints &watchpoints = mCpu.mSystemBus.watchpoints();
+    for (const Watchpoints::Hit &hit : watchpoints.hits()) {
+        logWatchHit(hit, instructionAddress);
     }
+    watchpoints.clearHits();
 }
 
 void Cpu65816Debugger::doBeforeStep(const std::function<void ()> handler) {
@@ -70,7 +81,15 @@ void Cpu65816Debugger::onStp(const std::function<void ()> handler) {
 }
 
 void Cpu65816Debugger::setBreakPoint(const Address &address) {
-    mBreakPointAddress = address;
+    mBreakPoints.add(address);
+}
+
+BreakpointSet &Cpu65816Debugger::breakPoints() {
+    return mBreakPoints;
+}
+
+void Cpu65816Debugger::resume() {
+    mBreakpointHit = false;
 }
 
 void Cpu65816Debugger::logStatusRegister() const {
@@ -87,120 +106,44 @@ void Cpu65816Debugger::dumpCpu() const {
     Log::trc(LOG_TAG).str("====== CPU status end ======").show();
 }
 
-void Cpu65816Debugger::logOpCode(OpCode &opCode) const {
-    Address onePlusOpCodeAddress = mCpu.mProgramAddress.newWithOffset(1);
-
-    Log &log = Log::trc(LOG_TAG);
-    log.hex(mCpu.mProgramAddress.getBank(), 2).str(":").hex(mCpu.mProgramAddress.getOffset(), 4);
-    log.str(" | ").hex(opCode.getCode(), 2).sp().str(opCode.getName()).sp();
-
-    switch(opCode.getAddressingMode()) {
-        case AddressingMode::Interrupt:
-        case AddressingMode::Accumulator:
-        case AddressingMode::Implied:
-            break;
-        case AddressingMode::Immediate:
-            // This refers to accumulator size to estimate the kind of value to print.
-            // Instructions using index registers might print the wrong value.
-            if (mCpu.accumulatorIs8BitWide()) {
-                log.str("#").hex(mCpu.mSystemBus.readByte(mCpu.getAddressOfOpCodeData(opCode)), 2);
-            } else {
-                log.str("#").hex(mCpu.mSystemBus.readTwoBytes(mCpu.getAddressOfOpCodeData(opCode)), 4);
-            }
-            break;
-        case AddressingMode::Absolute:
-            log.hex(mCpu.getAddressOfOpCodeData(opCode).getOffset(), 4).sp();
-            log.str("                    [Absolute]");
-            break;
-        case AddressingMode::AbsoluteLong:
-        {
-            Address opCodeDataAddress = mCpu.getAddressOfOpCodeData(opCode);
-            log.hex(opCodeDataAddress.getBank(), 2).str(":").hex(opCodeDataAddress.getOffset(), 4).sp();
-            log.str("                [Absolute Long]");
+void Cpu65816Debugger::logWatchHit(const Watchpoints::Hit &hit, const Address &instructionAddress) const {
+    const char *kind = hit.kind == WATCH_READ ? "read" : hit.kind == WATCH_WRITE ? "write" : "change";
+    Log &log = Log::dbg(LOG_TAG);
+    log.str("WATCHPOINT ").str(kind).sp()
+        .hex((hit.address >> 16) & 0xFF, 2).str(":").hex(hit.address & 0xFFFF, 4)
+        .str(" PC ").hex(instructionAddress.getBank(), 2).str(":").hex(instructionAddress.getOffset(), 4);
+    if (hit.kind != WATCH_READ) {
+        log.str(" old ");
+        if (hit.oldValue < 0) {
+            log.str("??");
+        } else {
+            log.hex(hit.oldValue, 2);
         }
-            break;
-        case AddressingMode::AbsoluteIndirect:
-            break;
-        case AddressingMode::AbsoluteIndirectLong:
-            break;
-        case AddressingMode::AbsoluteIndexedIndirectWithX:
-            break;
-        case AddressingMode::AbsoluteIndexedWithX:
-            log.hex(mCpu.mSystemBus.readTwoBytes(onePlusOpCodeAddress), 4).str(", X").sp();
-            log.str("                 [Absolute Indexed, X]");
-            break;
-        case AddressingMode::AbsoluteLongIndexedWithX:
-        {
-            Address opCodeDataAddress = mCpu.getAddressOfOpCodeData(opCode);
-            Address effectiveAddress = mCpu.mSystemBus.readAddressAt(opCodeDataAddress);
-            log.hex(effectiveAddress.getBank(), 2).str(":").hex(effectiveAddress.getOffset(), 4).str(", X").sp();
-            log.str("             [Absolute Long Indexed, X]");
-        }
-            break;
-        case AddressingMode::AbsoluteIndexedWithY:
-            log.hex(mCpu.mSystemBus.readTwoBytes(mCpu.getAddressOfOpCodeData(opCode)), 4).str(", Y").sp();
-            log.str("                    [Absolute Indexed, Y]");
-            break;
-        case AddressingMode::DirectPage:
-            log.hex(mCpu.mSystemBus.readByte(onePlusOpCodeAddress), 2).sp();
-            log.str("                      [Direct Page]");
-            break;
-        case AddressingMode::DirectPageIndexedWithX:
-            log.hex(mCpu.mSystemBus.readByte(onePlusOpCodeAddress), 2).str(", X").sp();
-            log.str("                    [Direct Page Indexed, X]");
-            break;
-        case AddressingMode::DirectPageIndexedWithY:
-            log.hex(mCpu.mSystemBus.readByte(onePlusOpCodeAddress), 2).str(", Y").sp();
-            log.str("                    [Direct Page Indexed, Y]");
-            break;
-        case AddressingMode::DirectPageIndirect:
-            log.str("(").hex(mCpu.mSystemBus.readByte(onePlusOpCodeAddress), 2).str(")").sp();
-            log.str("                    [Direct Page Indirect]");
-            break;
-        case AddressingMode::DirectPageIndirectLong:
-            log.str("[").hex(mCpu.mSystemBus.readByte(mCpu.getAddressOfOpCodeData(opCode)), 2).str("]").sp();
-            log.str("                    [Direct Page Indirect Long]");
-            break;
-        case AddressingMode::DirectPageIndexedIndirectWithX:
-            log.str("(").hex(mCpu.mSystemBus.readByte(Address(mCpu.mProgramAddress.getBank(),mCpu.mProgramAddress.getOffset()+1)), 2).str(", X)").sp();
-            log.str("                    [Direct Page Indexed Indirect, X]");
-            break;
-        case AddressingMode::DirectPageIndirectIndexedWithY:
-            log.str("(").hex(mCpu.mSystemBus.readByte(Address(mCpu.mProgramAddress.getBank(),mCpu.mProgramAddress.getOffset()+1)), 2).str("), Y").sp();
-            log.str("                    [Direct Page Indirect Indexed, Y]");
-            break;
-        case AddressingMode::DirectPageIndirectLongIndexedWithY:
-            log.str("[").hex(mCpu.mSystemBus.readByte(mCpu.getAddressOfOpCodeData(opCode)), 2).str("], Y").sp();
-            log.str("                    [Direct Page Indirect Indexed, Y]");
-            break;
-        case AddressingMode::StackImplied:
-            log.str("                          [Stack Implied]");
-            break;
-        case AddressingMode::StackRelative:
-            log.hex(mCpu.mSystemBus.readByte(mCpu.getAddressOfOpCodeData(opCode)), 2).str(", S").sp();
-            log.str("                    [Stack Relative]");
-            break;
-        case AddressingMode::StackAbsolute:
-            log.hex(mCpu.mSystemBus.readTwoBytes(mCpu.getAddressOfOpCodeData(opCode)), 4);
-            break;
-        case AddressingMode::StackDirectPageIndirect:
-            break;
-        case AddressingMode::StackProgramCounterRelativeLong:
-            break;
-        case AddressingMode::StackRelativeIndirectIndexedWithY:
-            log.str("(").hex(mCpu.mSystemBus.readByte(Address::sumOffsetToAddressWrapAround(mCpu.mProgramAddress, 1)), 2);
-            log.str(", S), Y").sp();
-            log.str("                    [Absolute Indexed, X]");
-            break;
-        case AddressingMode::ProgramCounterRelative:
-            log.hex(mCpu.mSystemBus.readByte(mCpu.getAddressOfOpCodeData(opCode)), 2).sp();
-            log.str("                      [Program Counter Relative]");
-            break;
-        case AddressingMode::ProgramCounterRelativeLong:
-            break;
-        case AddressingMode::BlockMove:
-            break;
+    }
+    log.str(" new ").hex(hit.newValue, 2).str(" cycle ").dec(mCpu.mTotalCyclesCounter).show();
+}
+
+void Cpu65816Debugger::logOpCode(OpCode &opCode) const {
+    const Address &programAddress = mCpu.mProgramAddress;
+    const bool m8 = mCpu.accumulatorIs8BitWide();
+    const bool x8 = mCpu.indexIs8BitWide();
+
+    // Peek at only the bytes the instruction occupies. Peeking leaves
+    // devices and watchpoints alone, so tracing does not read operands a
+    // second time on the bus ahead of the instruction itself.
+    uint8_t bytes[4];
+    bytes[0] = opCode.getCode();
+    const uint8_t length = Disassembler::instructionLength(bytes[0], m8, x8);
+    for (uint8_t i = 1; i < length; ++i) {
+        const int value = mCpu.mSystemBus.peekByte(Address::sumOffsetToAddressWrapAround(programAddress, i).getAbsolute());
+        bytes[i] = value < 0 ? 0 : (uint8_t)value;
     }
 
-    log.show();
-}
\ No newline at end of file
+    DecodedInstruction instruction;
+    Disassembler::decode(bytes, length, programAddress.getAbsolute(), m8, x8, instruction);
+    char text[Disassembler::MAX_TEXT_LENGTH];
+    Disassembler::format(instruction, text);
+
+    Log::trc(LOG_TAG).hex(programAddress.getBank(), 2).str(":").hex(programAddress.getOffset(), 4)
+        .str(" | ").hex(opCode.getCode(), 2).sp().str(text).show();
+}
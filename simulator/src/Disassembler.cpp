@@ -0,0 +1,217 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Disassembler.hpp"
+
+#include <cstring>
+
+constexpr OpCodeInfo Disassembler::OP_CODE_INFO[256];
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+// Append a string and return the new end of the buffer.
+char *put(char *out, const char *s) {
+    while (*s) *out++ = *s++;
+    return out;
+}
+
+// Append a value as the given number of hex digits.
+char *putHex(char *out, uint32_t value, int digits) {
+    for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+        *out++ = HEX_DIGITS[(value >> shift) & 0xF];
+    }
+    return out;
+}
+
+// Append a '$'-prefixed hex value.
+char *putValue(char *out, uint32_t value, int digits) {
+    *out++ = '$';
+    return putHex(out, value, digits);
+}
+
+} // namespace
+
+bool Disassembler::decode(const uint8_t *bytes, size_t size, uint32_t address,
+                          bool m8, bool x8, DecodedInstruction &out) {
+    if (size == 0) return false;
+    const uint8_t length = instructionLength(bytes[0], m8, x8);
+    if (size < length) return false;
+
+    out.address = address;
+    out.length = length;
+    out.info = &OP_CODE_INFO[bytes[0]];
+    out.bytes[1] = out.bytes[2] = out.bytes[3] = 0;
+    memcpy(out.bytes, bytes, length);
+    return true;
+}
+
+size_t Disassembler::format(const DecodedInstruction &in, char *out) {
+    char *p = put(out, in.info->mnemonic);
+    const uint32_t operand = in.operand();
+    const int digits = (in.length - 1) * 2;
+    const uint32_t bank = in.address & 0xFF0000;
+
+    if (in.length > 1) *p++ = ' ';
+
+    switch (in.info->mode) {
+        case AddressingMode::Accumulator:
+            p = put(p, " A");
+            break;
+        case AddressingMode::Implied:
+        case AddressingMode::StackImplied:
+            break;
+        case AddressingMode::Interrupt:
+        case AddressingMode::Immediate:
+            *p++ = '#';
+            p = putValue(p, operand, digits);
+            break;
+        case AddressingMode::Absolute:
+        case AddressingMode::AbsoluteLong:
+        case AddressingMode::DirectPage:
+        case AddressingMode::StackAbsolute:
+            p = putValue(p, operand, digits);
+            break;
+        case AddressingMode::AbsoluteIndexedWithX:
+        case AddressingMode::AbsoluteLongIndexedWithX:
+        case AddressingMode::DirectPageIndexedWithX:
+            p = putValue(p, operand, digits);
+            p = put(p, ",X");
+            break;
+        case AddressingMode::AbsoluteIndexedWithY:
+        case AddressingMode::DirectPageIndexedWithY:
+            p = putValue(p, operand, digits);
+            p = put(p, ",Y");
+            break;
+        case AddressingMode::AbsoluteIndirect:
+        case AddressingMode::DirectPageIndirect:
+        case AddressingMode::StackDirectPageIndirect:
+            *p++ = '(';
+            p = putValue(p, operand, digits);
+            *p++ = ')';
+            break;
+        case AddressingMode::AbsoluteIndirectLong:
+        case AddressingMode::DirectPageIndirectLong:
+            *p++ = '[';
+            p = putValue(p, operand, digits);
+            *p++ = ']';
+            break;
+        case AddressingMode::AbsoluteIndexedIndirectWithX:
+        case AddressingMode::DirectPageIndexedIndirectWithX:
+            *p++ = '(';
+            p = putValue(p, operand, digits);
+            p = put(p, ",X)");
+            break;
+        case AddressingMode::DirectPageIndirectIndexedWithY:
+            *p++ = '(';
+            p = putValue(p, operand, digits);
+            p = put(p, "),Y");
+            break;
+        case AddressingMode::DirectPageIndirectLongIndexedWithY:
+            *p++ = '[';
+            p = putValue(p, operand, digits);
+            p = put(p, "],Y");
+            break;
+        case AddressingMode::StackRelative:
+            p = putValue(p, operand, digits);
+            p = put(p, ",S");
+            break;
+        case AddressingMode::StackRelativeIndirectIndexedWithY:
+            *p++ = '(';
+            p = putValue(p, operand, digits);
+            p = put(p, ",S),Y");
+            break;
+        case AddressingMode::ProgramCounterRelative:
+        {
+            // Branch targets wrap within the program bank.
+            uint16_t target = (uint16_t)(in.address + 2 + (int8_t)operand);
+            p = putValue(p, bank | target, 6);
+            break;
+        }
+        case AddressingMode::ProgramCounterRelativeLong:
+        case AddressingMode::StackProgramCounterRelativeLong:
+        {
+            uint16_t target = (uint16_t)(in.address + 3 + (int16_t)operand);
+            p = putValue(p, bank | target, 6);
+            break;
+        }
+        case AddressingMode::BlockMove:
+            // Encoded as destination then source; written source first.
+            p = putValue(p, in.bytes[2], 2);
+            *p++ = ',';
+            p = putValue(p, in.bytes[1], 2);
+            break;
+    }
+
+    *p = '\0';
+    return p - out;
+}
+
+size_t Disassembler::disassemble(const uint8_t *bytes, size_t size, uint32_t base,
+                                 bool m8, bool x8, std::ostream &out) {
+    // Address, up to four bytes of hex and the instruction text.
+    char line[8 + 13 + MAX_TEXT_LENGTH + 1];
+    size_t count = 0;
+    size_t offset = 0;
+
+    while (offset < size) {
+        DecodedInstruction instruction;
+        const uint32_t address = (base + offset) & 0xFFFFFF;
+        if (!decode(bytes + offset, size - offset, address, m8, x8, instruction)) {
+            // Trailing bytes that do not form a whole instruction.
+            char *p = putHex(line, address, 6);
+            p = put(p, "  ");
+            for (size_t i = offset; i < size; ++i) {
+                p = putHex(p, bytes[i], 2);
+                *p++ = ' ';
+            }
+            *p++ = '\n';
+            out.write(line, p - line);
+            break;
+        }
+
+        char *p = putHex(line, address, 6);
+        p = put(p, "  ");
+        for (uint8_t i = 0; i < 4; ++i) {
+            if (i < instruction.length) {
+                p = putHex(p, instruction.bytes[i], 2);
+            } else {
+                p = put(p, "  ");
+            }
+            *p++ = ' ';
+        }
+        *p++ = ' ';
+        p += format(instruction, p);
+        *p++ = '\n';
+        out.write(line, p - line);
+
+        // Follow REP and SEP so immediate operand sizes stay in step.
+        if (instruction.bytes[0] == 0xC2) {
+            if (instruction.bytes[1] & 0x20) m8 = false;
+            if (instruction.bytes[1] & 0x10) x8 = false;
+        } else if (instruction.bytes[0] == 0xE2) {
+            if (instruction.bytes[1] & 0x20) m8 = true;
+            if (instruction.bytes[1] & 0x10) x8 = true;
+        }
+
+        offset += instruction.length;
+        ++count;
+    }
+
+    return count;
+}
@@ -0,0 +1,198 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "DmaController.hpp"
+#include "DeviceState.hpp"
+#include "Log.hpp"
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#define LOG_TAG "DmaController"
+
+// Bytes of registers.
+#define DMA_SIZE 0x10
+
+// Bus cycles per byte moved: one read and one write.
+#define CYCLES_PER_BYTE 2
+
+DmaController::DmaController(const Address &baseAddr, SystemBus &bus) : mBase(baseAddr.getAbsolute()),
+                                                                        mBus(bus),
+                                                                        mIrqSource(bus.irq().addSource()),
+                                                                        mSource(0),
+                                                                        mDest(0),
+                                                                        mCount(0),
+                                                                        mControl(0),
+                                                                        mStatus(0),
+                                                                        mCredit(0),
+                                                                        mOwed(0) {
+}
+
+void DmaController::storeByte(const Address &addr, uint8_t val) {
+    const uint16_t reg = addr.getOffset();
+    const int shift = 8 * ((reg - DMA_SOURCE) % 3);
+    const uint32_t mask = ~((uint32_t)0xFF << shift);
+
+    // The transfer registers are read-only while busy.
+    if (reg < DMA_CONTROL && (mStatus & DMA_BUSY)) return;
+
+    if (reg < DMA_DEST) {
+        mSource = (mSource & mask) | ((uint32_t)val << shift);
+    } else if (reg < DMA_COUNT) {
+        mDest = (mDest & mask) | ((uint32_t)val << shift);
+    } else if (reg < DMA_CONTROL) {
+        mCount = (mCount & mask) | ((uint32_t)val << shift);
+    } else if (reg == DMA_CONTROL) {
+        mControl = val & (DMA_SRC_FIXED | DMA_DST_FIXED | DMA_BURST | DMA_IRQ_ENABLE);
+        if ((val & DMA_START) && !(mStatus & DMA_BUSY)) start();
+    } else if (reg == DMA_STATUS) {
+        if (val & DMA_DONE) {
+            mStatus &= ~DMA_DONE;
+            mBus.irq().releaseSource(mIrqSource);
+        }
+    }
+}
+
+uint8_t DmaController::readByte(const Address &addr) {
+    const uint16_t reg = addr.getOffset();
+    const int shift = 8 * ((reg - DMA_SOURCE) % 3);
+    if (reg < DMA_DEST) return (uint8_t)(mSource >> shift);
+    if (reg < DMA_COUNT) return (uint8_t)(mDest >> shift);
+    if (reg < DMA_CONTROL) return (uint8_t)(mCount >> shift);
+    if (reg == DMA_CONTROL) return mControl | ((mStatus & DMA_BUSY) ? DMA_START : 0);
+    if (reg == DMA_STATUS) return mStatus;
+    return 0;
+}
+
+bool DmaController::decodeAddress(const Address &in, Address &out) {
+    uint32_t addr = in.getAbsolute() - mBase;
+    out = Address((addr >> 16) & 0xFF, addr & 0xFFFF);
+    return addr < DMA_SIZE;
+}
+
+bool DmaController::getAddressRange(uint32_t &first, uint32_t &size) {
+    first = mBase;
+    size = DMA_SIZE;
+    return true;
+}
+
+void DmaController::addCycles(int cycles) {
+    // Cycles the CPU spent stalled for us were ours already.
+    const int owed = std::min(cycles, mOwed);
+    mOwed -= owed;
+    cycles -= owed;
+    if (!(mStatus & DMA_BUSY) || cycles <= 0) return;
+
+    // Every other bus cycle goes to the transfer.
+    mCredit += cycles;
+    const uint32_t bytes = std::min((uint32_t)(mCredit / CYCLES_PER_BYTE), mCount);
+    mCredit -= bytes * CYCLES_PER_BYTE;
+    transfer(bytes);
+    mOwed += steal(bytes);
+    if (!mCount) complete();
+}
+
+void DmaController::saveState(DeviceState &state) {
+    state.put(mSource);
+    state.put(mDest);
+    state.put(mCount);
+    state.put(mControl);
+    state.put(mStatus);
+    state.put(mCredit);
+    state.put(mOwed);
+}
+
+void DmaController::restoreState(DeviceState &state) {
+    mSource = state.get<uint32_t>();
+    mDest = state.get<uint32_t>();
+    mCount = state.get<uint32_t>();
+    mControl = state.get<uint8_t>();
+    mStatus = state.get<uint8_t>();
+    mCredit = state.get<int>();
+    mOwed = state.get<int>();
+    if ((mStatus & DMA_DONE) && (mControl & DMA_IRQ_ENABLE)) {
+        mBus.irq().assertSource(mIrqSource);
+    } else {
+        mBus.irq().releaseSource(mIrqSource);
+    }
+}
+
+void DmaController::addMetrics(MetricsGroup &group) {
+    group.setKind("dma");
+}
+
+void DmaController::start() {
+    Log::trc(LOG_TAG).str("Moving ").hex(mCount, 6).str(" bytes from ").hex(mSource, 6)
+        .str(" to ").hex(mDest, 6).show();
+    mStatus = (mStatus & ~DMA_DONE) | DMA_BUSY;
+    mBus.irq().releaseSource(mIrqSource);
+    mCredit = 0;
+
+    if (mControl & DMA_BURST) {
+        const uint32_t bytes = mCount;
+        transfer(bytes);
+        steal(bytes);
+    }
+    if (!mCount) complete();
+}
+
+void DmaController::transfer(uint32_t bytes) {
+    const bool sourceFixed = mControl & DMA_SRC_FIXED;
+    const bool destFixed = mControl & DMA_DST_FIXED;
+
+    while (bytes) {
+        // Stay within one page of each incrementing address.
+        uint32_t run = bytes;
+        if (!sourceFixed) run = std::min(run, 0x100 - (mSource & 0xFF));
+        if (!destFixed) run = std::min(run, 0x100 - (mDest & 0xFF));
+
+        const uint8_t *from = sourceFixed ? 0 : mBus.readPage(mSource);
+        uint8_t *to = destFixed ? 0 : mBus.writePage(mDest);
+        if (from) from += mSource & 0xFF;
+        if (to) to += mDest & 0xFF;
+
+        // A destination just ahead of the source sees bytes already
+        // copied, as a byte-at-a-time transfer would.
+        if (from && to && !(to > from && to < from + run)) {
+            memmove(to, from, run);
+        } else {
+            for (uint32_t i = 0; i < run; ++i) {
+                const uint32_t source = sourceFixed ? mSource : mSource + i;
+                const uint32_t dest = destFixed ? mDest : mDest + i;
+                const uint8_t val = mBus.readByte(Address((source >> 16) & 0xFF, source & 0xFFFF));
+                mBus.storeByte(Address((dest >> 16) & 0xFF, dest & 0xFFFF), val);
+            }
+        }
+
+        if (!sourceFixed) mSource = (mSource + run) & 0xFFFFFF;
+        if (!destFixed) mDest = (mDest + run) & 0xFFFFFF;
+        mCount -= run;
+        bytes -= run;
+    }
+}
+
+void DmaController::complete() {
+    mStatus = (mStatus & ~DMA_BUSY) | DMA_DONE;
+    if (mControl & DMA_IRQ_ENABLE) mBus.irq().assertSource(mIrqSource);
+}
+
+int DmaController::steal(uint32_t bytes) {
+    const int cycles = (int)(bytes * CYCLES_PER_BYTE);
+    if (cycles) mBus.stall(cycles);
+    return cycles;
+}
@@ -0,0 +1,622 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "GdbServer.hpp"
+#include "Log.hpp"
+#include "Metrics.hpp"
+#include "Rewind.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET Socket;
+#define INVALID_HANDLE ((intptr_t)INVALID_SOCKET)
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int Socket;
+#define INVALID_HANDLE ((intptr_t)-1)
+#endif
+
+// A debugger that goes away should end the session, not the process.
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define LOG_TAG "GdbServer"
+
+// Cycles run between checks for an interrupt from the debugger.
+#define SLICE_CYCLES 1000000
+
+// Largest packet accepted, and advertised in qSupported.
+#define PACKET_SIZE 0x1000
+
+namespace {
+
+// Register sizes in bytes, in target.xml order.
+const unsigned REGISTER_SIZES[] = { 4, 2, 2, 2, 2, 2, 1, 1, 1 };
+const unsigned REGISTER_COUNT = sizeof(REGISTER_SIZES) / sizeof(REGISTER_SIZES[0]);
+
+const char TARGET_XML[] =
+    "<?xml version=\"1.0\"?>"
+    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+    "<target version=\"1.0\">"
+    "<feature name=\"org.dt65pc.w65c816\">"
+    "<reg name=\"pc\" bitsize=\"32\" type=\"code_ptr\"/>"
+    "<reg name=\"a\" bitsize=\"16\" type=\"uint16\"/>"
+    "<reg name=\"x\" bitsize=\"16\" type=\"uint16\"/>"
+    "<reg name=\"y\" bitsize=\"16\" type=\"uint16\"/>"
+    "<reg name=\"sp\" bitsize=\"16\" type=\"uint16\"/>"
+    "<reg name=\"d\" bitsize=\"16\" type=\"uint16\"/>"
+    "<reg name=\"dbr\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"p\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"e\" bitsize=\"8\" type=\"uint8\"/>"
+    "</feature>"
+    "</target>";
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void appendHex(std::string &out, uint8_t val) {
+    out += HEX_DIGITS[val >> 4];
+    out += HEX_DIGITS[val & 0xF];
+}
+
+// Little-endian hex of the low bytes of a value, as registers are sent.
+void appendValue(std::string &out, uint32_t val, unsigned bytes) {
+    for (unsigned i = 0; i < bytes; ++i) {
+        appendHex(out, (uint8_t)(val >> (8 * i)));
+    }
+}
+
+bool parseValue(const std::string &hex, uint32_t &val) {
+    if (hex.empty() || hex.size() > 8 || hex.size() % 2) return false;
+    val = 0;
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        const int high = hexValue(hex[i]);
+        const int low = hexValue(hex[i + 1]);
+        if (high < 0 || low < 0) return false;
+        val |= (uint32_t)(high << 4 | low) << (4 * i);
+    }
+    return true;
+}
+
+// Parse a big-endian hex number, as addresses and lengths are sent.
+bool parseNumber(const std::string &text, uint32_t &val) {
+    if (text.empty() || text.size() > 8) return false;
+    val = 0;
+    for (char c : text) {
+        const int digit = hexValue(c);
+        if (digit < 0) return false;
+        val = val << 4 | digit;
+    }
+    return true;
+}
+
+// Split "ADDR,LENGTH" at the comma.
+bool parseRange(const std::string &text, uint32_t &addr, uint32_t &length) {
+    const size_t comma = text.find(',');
+    return comma != std::string::npos && parseNumber(text.substr(0, comma), addr)
+        && parseNumber(text.substr(comma + 1), length);
+}
+
+bool startsWith(const std::string &s, const char *prefix) {
+    return s.compare(0, strlen(prefix), prefix) == 0;
+}
+
+} // namespace
+
+GdbServer::GdbServer(Machine &machine) : mMachine(machine),
+                                         mListener(INVALID_HANDLE),
+                                         mConnection(INVALID_HANDLE),
+                                         mNoAck(false),
+                                         mLastStop(StopReason::CycleBudget),
+                                         mRewind(0),
+                                         mMetrics(0) {
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+GdbServer::~GdbServer() {
+    closeSocket(mConnection);
+    closeSocket(mListener);
+#ifdef _WIN32
+    WSACleanup();
+#else
+    if (!mSocketPath.empty()) unlink(mSocketPath.c_str());
+#endif
+}
+
+void GdbServer::closeSocket(intptr_t &fd) {
+    if (fd == INVALID_HANDLE) return;
+#ifdef _WIN32
+    closesocket((Socket)fd);
+#else
+    close((Socket)fd);
+#endif
+    fd = INVALID_HANDLE;
+}
+
+bool GdbServer::listen(const std::string &where, std::string &error) {
+    char *end;
+    const unsigned long port = strtoul(where.c_str(), &end, 10);
+    const bool tcp = !where.empty() && *end == '\0';
+    if (tcp) {
+        if (port == 0 || port > 0xFFFF) {
+            error = "bad port " + where;
+            return false;
+        }
+        mListener = (intptr_t)socket(AF_INET, SOCK_STREAM, 0);
+        if (mListener == INVALID_HANDLE) {
+            error = "cannot create a socket";
+            return false;
+        }
+        const int on = 1;
+        setsockopt((Socket)mListener, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof(on));
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind((Socket)mListener, (const sockaddr *)&address, sizeof(address)) != 0) {
+            closeSocket(mListener);
+            error = "cannot listen on port " + where;
+            return false;
+        }
+    } else {
+#ifdef _WIN32
+        error = "Unix sockets are not supported; give a port";
+        return false;
+#else
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        if (where.size() >= sizeof(address.sun_path)) {
+            error = "socket path too long: " + where;
+            return false;
+        }
+        mListener = (intptr_t)socket(AF_UNIX, SOCK_STREAM, 0);
+        if (mListener == INVALID_HANDLE) {
+            error = "cannot create a socket";
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, where.c_str());
+        unlink(where.c_str());
+        if (bind((Socket)mListener, (const sockaddr *)&address, sizeof(address)) != 0) {
+            closeSocket(mListener);
+            error = "cannot create socket " + where;
+            return false;
+        }
+        mSocketPath = where;
+#endif
+    }
+    if (::listen((Socket)mListener, 1) != 0) {
+        closeSocket(mListener);
+        error = "cannot listen on " + where;
+        return false;
+    }
+    Log::vrb(LOG_TAG).str("Waiting for a debugger on ").str(where.c_str()).show();
+    return true;
+}
+
+bool GdbServer::serve(std::string &error) {
+    mConnection = (intptr_t)accept((Socket)mListener, 0, 0);
+    if (mConnection == INVALID_HANDLE) {
+        error = "cannot accept a debugger connection";
+        return false;
+    }
+    if (mSocketPath.empty()) {
+        const int on = 1;
+        setsockopt((Socket)mConnection, IPPROTO_TCP, TCP_NODELAY, (const char *)&on, sizeof(on));
+    }
+    Log::vrb(LOG_TAG).str("Debugger connected").show();
+
+    mNoAck = false;
+    mInput.clear();
+    std::string packet;
+    bool done = false;
+    while (!done && readPacket(packet)) {
+        const std::string reply = handle(packet, done);
+        // There is no reply to kill; the connection simply ends.
+        if (packet == "k" || !sendPacket(reply)) break;
+        // No-ack mode starts once the reply agreeing to it is acknowledged.
+        if (packet == "QStartNoAckMode") mNoAck = true;
+    }
+
+    closeSocket(mConnection);
+    Log::vrb(LOG_TAG).str("Debugger disconnected").show();
+    return true;
+}
+
+bool GdbServer::readByte(char &c) {
+    if (mInput.empty()) {
+        char buffer[PACKET_SIZE];
+        const int count = (int)recv((Socket)mConnection, buffer, sizeof(buffer), 0);
+        if (count <= 0) return false;
+        mInput.assign(buffer, count);
+    }
+    c = mInput[0];
+    mInput.erase(0, 1);
+    return true;
+}
+
+bool GdbServer::readPacket(std::string &packet) {
+    for (;;) {
+        // Skip acknowledgements and interrupts that arrive while stopped.
+        char c;
+        do {
+            if (!readByte(c)) return false;
+        } while (c != '$');
+
+        packet.clear();
+        uint8_t sum = 0;
+        while (readByte(c) && c != '#') {
+            packet += c;
+            sum += (uint8_t)c;
+        }
+        char high, low;
+        if (c != '#' || !readByte(high) || !readByte(low)) return false;
+        if (mNoAck) return true;
+
+        const bool good = hexValue(high) >= 0 && hexValue(low) >= 0
+            && (uint8_t)(hexValue(high) << 4 | hexValue(low)) == sum;
+        if (send((Socket)mConnection, good ? "+" : "-", 1, MSG_NOSIGNAL) != 1) return false;
+        if (good) return true;
+    }
+}
+
+bool GdbServer::sendPacket(const std::string &data) {
+    std::string frame = "$";
+    uint8_t sum = 0;
+    for (char c : data) {
+        frame += c;
+        sum += (uint8_t)c;
+    }
+    frame += '#';
+    appendHex(frame, sum);
+
+    for (;;) {
+        if (send((Socket)mConnection, frame.data(), (int)frame.size(), MSG_NOSIGNAL) != (int)frame.size()) return false;
+        if (mNoAck) return true;
+        char c;
+        do {
+            if (!readByte(c)) return false;
+        } while (c != '+' && c != '-');
+        if (c == '+') return true;
+    }
+}
+
+bool GdbServer::interruptRequested() {
+    if (mInput.empty()) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET((Socket)mConnection, &readable);
+        timeval timeout = { 0, 0 };
+        if (select((int)mConnection + 1, &readable, 0, 0, &timeout) <= 0) return false;
+        char c;
+        if (!readByte(c)) return true;
+        mInput.insert(0, 1, c);
+    }
+    // The debugger sends a bare ^C to interrupt.
+    const size_t interrupt = mInput.find('\x03');
+    if (interrupt == std::string::npos) return false;
+    mInput.erase(interrupt, 1);
+    return true;
+}
+
+std::string GdbServer::handle(const std::string &packet, bool &done) {
+    if (packet.empty()) return "";
+    const std::string args = packet.substr(1);
+    switch (packet[0]) {
+        case '?':
+            return "S05";
+        case 'g':
+            return readRegisters();
+        case 'G': {
+            const std::string all = args;
+            size_t pos = 0;
+            for (unsigned i = 0; i < REGISTER_COUNT; ++i) {
+                if (pos + 2 * REGISTER_SIZES[i] > all.size()
+                        || !writeRegister(i, all.substr(pos, 2 * REGISTER_SIZES[i]))) {
+                    return "E01";
+                }
+                pos += 2 * REGISTER_SIZES[i];
+            }
+            return "OK";
+        }
+        case 'p': {
+            uint32_t number;
+            if (!parseNumber(args, number) || number >= REGISTER_COUNT) return "E01";
+            const std::string all = readRegisters();
+            size_t pos = 0;
+            for (unsigned i = 0; i < number; ++i) pos += 2 * REGISTER_SIZES[i];
+            return all.substr(pos, 2 * REGISTER_SIZES[number]);
+        }
+        case 'P': {
+            const size_t equals = args.find('=');
+            uint32_t number;
+            if (equals == std::string::npos || !parseNumber(args.substr(0, equals), number)
+                    || number >= REGISTER_COUNT || args.size() - equals - 1 != 2 * REGISTER_SIZES[number]
+                    || !writeRegister(number, args.substr(equals + 1))) {
+                return "E01";
+            }
+            return "OK";
+        }
+        case 'm':
+            return readMemory(args);
+        case 'M':
+            return writeMemory(args);
+        case 'c':
+        case 's': {
+            if (!args.empty()) {
+                uint32_t addr;
+                if (!parseNumber(args, addr)) return "E01";
+                Cpu65816::Registers registers = mMachine.cpu().getRegisters();
+                registers.pbr = (addr >> 16) & 0xFF;
+                registers.pc = addr & 0xFFFF;
+                mMachine.cpu().setRegisters(registers);
+            }
+            return resume(packet[0] == 's');
+        }
+        case 'b':
+            if (!mRewind || (args != "s" && args != "c")) return "";
+            return reverse(args == "s");
+        case 'Z':
+        case 'z':
+            return changePoint(args, packet[0] == 'Z');
+        case 'q':
+        case 'Q':
+            return query(packet);
+        case 'H':
+            return "OK";
+        case 'D':
+            done = true;
+            return "OK";
+        case 'k':
+            done = true;
+            return "";
+    }
+    return "";
+}
+
+std::string GdbServer::resume(bool step) {
+    Watchpoints &watchpoints = mMachine.bus().watchpoints();
+    watchpoints.clearHits();
+    if (step) {
+        // Any budget runs exactly one instruction.
+        mLastStop = run(1, STOP_ON_WATCHPOINT);
+        if (mLastStop == StopReason::CycleBudget) mLastStop = StopReason::DeviceRequest;
+        return stopReply(mLastStop);
+    }
+    for (;;) {
+        mLastStop = run(SLICE_CYCLES, STOP_ON_ALL);
+        if (mMetrics) mMetrics->poll();
+        if (mLastStop != StopReason::CycleBudget) return stopReply(mLastStop);
+        if (interruptRequested()) return "S02";
+    }
+}
+
+std::string GdbServer::reverse(bool step) {
+    mMachine.bus().watchpoints().clearHits();
+    if (step) {
+        mLastStop = mRewind->stepBack() ? StopReason::DeviceRequest : StopReason::HistoryStart;
+    } else {
+        mLastStop = mRewind->continueBack();
+    }
+    return stopReply(mLastStop);
+}
+
+StopReason GdbServer::run(uint64_t maxCycles, unsigned stopConditions) {
+    if (mRewind) return mRewind->run(maxCycles, stopConditions);
+    return mMachine.run(maxCycles, stopConditions);
+}
+
+std::string GdbServer::stopReply(StopReason reason) {
+    switch (reason) {
+        case StopReason::Stp:
+            // STP holds the CPU until reset, which is the end of the program.
+            return "W00";
+        case StopReason::Unimplemented:
+            return "S04";
+        case StopReason::Breakpoint:
+            return "T05swbreak:;";
+        case StopReason::HistoryStart:
+            return "T05replaylog:begin;";
+        case StopReason::Watchpoint: {
+            Watchpoints &watchpoints = mMachine.bus().watchpoints();
+            if (!watchpoints.hasHits()) return "S05";
+            const Watchpoints::Hit hit = watchpoints.hits().front();
+            watchpoints.clearHits();
+            std::ostringstream out;
+            out << "T05" << watchName(hit) << ":" << std::hex << hit.address << ";";
+            return out.str();
+        }
+        default:
+            return "S05";
+    }
+}
+
+std::string GdbServer::readRegisters() {
+    const Cpu65816::Registers registers = mMachine.cpu().getRegisters();
+    std::string out;
+    appendValue(out, (uint32_t)registers.pbr << 16 | registers.pc, 4);
+    appendValue(out, registers.a, 2);
+    appendValue(out, registers.x, 2);
+    appendValue(out, registers.y, 2);
+    appendValue(out, registers.s, 2);
+    appendValue(out, registers.d, 2);
+    appendValue(out, registers.dbr, 1);
+    appendValue(out, registers.p, 1);
+    appendValue(out, registers.e, 1);
+    return out;
+}
+
+bool GdbServer::writeRegister(unsigned number, const std::string &hex) {
+    uint32_t val;
+    if (!parseValue(hex, val)) return false;
+    Cpu65816::Registers registers = mMachine.cpu().getRegisters();
+    switch (number) {
+        case 0:
+            registers.pbr = (val >> 16) & 0xFF;
+            registers.pc = val & 0xFFFF;
+            break;
+        case 1: registers.a = (uint16_t)val; break;
+        case 2: registers.x = (uint16_t)val; break;
+        case 3: registers.y = (uint16_t)val; break;
+        case 4: registers.s = (uint16_t)val; break;
+        case 5: registers.d = (uint16_t)val; break;
+        case 6: registers.dbr = (uint8_t)val; break;
+        case 7: registers.p = (uint8_t)val; break;
+        case 8: registers.e = val != 0; break;
+        default: return false;
+    }
+    mMachine.cpu().setRegisters(registers);
+    return true;
+}
+
+std::string GdbServer::readMemory(const std::string &args) {
+    uint32_t addr, length;
+    if (!parseRange(args, addr, length)) return "E01";
+    if (length > PACKET_SIZE / 2) length = PACKET_SIZE / 2;
+
+    // Device registers cannot be read without side effects, so a read
+    // stops short at the first one.
+    std::string out;
+    for (uint32_t i = 0; i < length; ++i) {
+        const int val = mMachine.bus().peekByte((addr + i) & 0xFFFFFF);
+        if (val < 0) break;
+        appendHex(out, (uint8_t)val);
+    }
+    return out.empty() && length ? "E14" : out;
+}
+
+std::string GdbServer::writeMemory(const std::string &args) {
+    const size_t colon = args.find(':');
+    uint32_t addr, length;
+    if (colon == std::string::npos || !parseRange(args.substr(0, colon), addr, length)
+            || args.size() - colon - 1 != 2 * (size_t)length) {
+        return "E01";
+    }
+    std::string bytes;
+    for (size_t pos = colon + 1; pos < args.size(); pos += 2) {
+        const int high = hexValue(args[pos]);
+        const int low = hexValue(args[pos + 1]);
+        if (high < 0 || low < 0) return "E01";
+        bytes += (char)(high << 4 | low);
+    }
+
+    // Stored as the CPU would, but the debugger's own writes are not
+    // watchpoint triggers.
+    Watchpoints &watchpoints = mMachine.bus().watchpoints();
+    const bool hadHits = watchpoints.hasHits();
+    mMachine.bus().storeBytes(addr & 0xFFFFFF, (const uint8_t *)bytes.data(), length);
+    if (!hadHits) watchpoints.clearHits();
+    return "OK";
+}
+
+const char *GdbServer::watchName(const Watchpoints::Hit &hit) const {
+    // The bus only says whether the access was a read or a write. An
+    // access watchpoint (Z4) is reported as such unless a watchpoint of
+    // the matching single kind also covers the address.
+    const char single = hit.kind == WATCH_READ ? '3' : '2';
+    bool access = false;
+    for (const auto &entry : mWatches) {
+        const uint32_t first = std::get<1>(entry.first);
+        const uint32_t length = std::get<2>(entry.first);
+        if (((hit.address - first) & 0xFFFFFF) >= length) continue;
+        if (std::get<0>(entry.first) == single) return single == '3' ? "rwatch" : "watch";
+        if (std::get<0>(entry.first) == '4') access = true;
+    }
+    if (access) return "awatch";
+    return hit.kind == WATCH_READ ? "rwatch" : "watch";
+}
+
+std::string GdbServer::changePoint(const std::string &args, bool insert) {
+    // TYPE,ADDR,KIND
+    uint32_t addr, length;
+    if (args.size() < 2 || args[1] != ',' || !parseRange(args.substr(2), addr, length)) return "E01";
+    addr &= 0xFFFFFF;
+    const char type = args[0];
+    switch (type) {
+        case '0':
+        case '1': {
+            const Address address((addr >> 16) & 0xFF, addr & 0xFFFF);
+            if (insert) mMachine.breakPoints().add(address);
+            else mMachine.breakPoints().remove(address);
+            return "OK";
+        }
+        case '2':
+        case '3':
+        case '4': {
+            if (length == 0) length = 1;
+            const auto key = std::make_tuple(type, addr, length);
+            auto it = mWatches.find(key);
+            if (insert) {
+                if (it != mWatches.end()) return "OK";
+                const uint8_t kinds = type == '2' ? WATCH_WRITE : type == '3' ? WATCH_READ : WATCH_READ | WATCH_WRITE;
+                const uint32_t last = (addr + length - 1) & 0xFFFFFF;
+                mWatches[key] = mMachine.bus().addWatchpoint(
+                    Address((addr >> 16) & 0xFF, addr & 0xFFFF), Address((last >> 16) & 0xFF, last & 0xFFFF), kinds);
+            } else if (it != mWatches.end()) {
+                mMachine.bus().removeWatchpoint(it->second);
+                mWatches.erase(it);
+            }
+            return "OK";
+        }
+    }
+    return "";
+}
+
+std::string GdbServer::query(const std::string &packet) {
+    if (startsWith(packet, "qSupported")) {
+        std::ostringstream out;
+        out << "PacketSize=" << std::hex << PACKET_SIZE << ";qXfer:features:read+;QStartNoAckMode+;swbreak+;hwbreak+";
+        if (mRewind) out << ";ReverseStep+;ReverseContinue+";
+        return out.str();
+    }
+    if (packet == "QStartNoAckMode") return "OK";
+    if (startsWith(packet, "qXfer:features:read:target.xml:")) {
+        uint32_t offset, length;
+        if (!parseRange(packet.substr(31), offset, length)) return "E01";
+        const std::string xml(TARGET_XML);
+        if (offset >= xml.size()) return "l";
+        const std::string part = xml.substr(offset, length);
+        return (offset + part.size() < xml.size() ? "m" : "l") + part;
+    }
+    if (packet == "qAttached") return "1";
+    if (packet == "qC") return "QC1";
+    if (packet == "qfThreadInfo") return "m1";
+    if (packet == "qsThreadInfo") return "l";
+    return "";
+}
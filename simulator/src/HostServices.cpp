@@ -0,0 +1,157 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "HostServices.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Address in the data bank, carrying into the following banks.
+Address dataAddress(const Cpu65816::Registers &registers, uint32_t offset) {
+    const uint32_t address = (((uint32_t)registers.dbr << 16) + offset) & 0xFFFFFF;
+    return Address((uint8_t)(address >> 16), (uint16_t)address);
+}
+
+// Address in the direct page, which stays in bank zero.
+Address directAddress(const Cpu65816::Registers &registers, uint32_t offset) {
+    return Address(0x00, (uint16_t)(registers.d + offset));
+}
+
+bool wide(const Cpu65816::Registers &registers) {
+    return !registers.e && (registers.p & 0x30) == 0;
+}
+
+uint32_t readDirect32(SystemBus &bus, const Cpu65816::Registers &registers, uint32_t offset) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) value = value << 8 | bus.readByte(directAddress(registers, offset + i));
+    return value;
+}
+
+void storeDirect(SystemBus &bus, const Cpu65816::Registers &registers, uint32_t offset, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) bus.storeByte(directAddress(registers, offset + i), (uint8_t)(value >> (8 * i)));
+}
+
+bool serviceMul32(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &) {
+    if (!wide(registers)) return false;
+    const uint64_t product = (uint64_t)readDirect32(bus, registers, registers.x)
+        * readDirect32(bus, registers, registers.x + 4);
+    storeDirect(bus, registers, registers.x + 8, product, 8);
+    return true;
+}
+
+bool serviceDiv32(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &) {
+    if (!wide(registers)) return false;
+    const uint32_t dividend = readDirect32(bus, registers, registers.x);
+    const uint32_t divisor = readDirect32(bus, registers, registers.x + 4);
+    if (divisor == 0) return false;
+    storeDirect(bus, registers, registers.x + 8, dividend / divisor, 4);
+    storeDirect(bus, registers, registers.x + 12, dividend % divisor, 4);
+    return true;
+}
+
+bool serviceUl2a(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &bytes) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) value = value << 8 | bus.readByte(Address(0x00, (uint16_t)(registers.s + 4 + i)));
+    const uint16_t buffer = bus.readByte(Address(0x00, (uint16_t)(registers.s + 8)))
+        | (uint16_t)bus.readByte(Address(0x00, (uint16_t)(registers.s + 9))) << 8;
+
+    char digits[16];
+    snprintf(digits, sizeof(digits), "%012lu", (unsigned long)value);
+    for (int i = 0; i <= 12; ++i) bus.storeByte(dataAddress(registers, buffer + i), (uint8_t)digits[i]);
+    bytes = 13;
+    return true;
+}
+
+bool serviceMemFill(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &bytes) {
+    if (!wide(registers)) return false;
+    for (uint32_t i = 0; i < registers.y; ++i) bus.storeByte(dataAddress(registers, registers.x + i), (uint8_t)registers.a);
+    bytes = registers.y;
+    return true;
+}
+
+bool serviceMemCpy(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &bytes) {
+    if (!wide(registers)) return false;
+    std::vector<uint8_t> copy(registers.a);
+    for (uint32_t i = 0; i < copy.size(); ++i) copy[i] = bus.readByte(dataAddress(registers, registers.x + i));
+    for (uint32_t i = 0; i < copy.size(); ++i) bus.storeByte(dataAddress(registers, registers.y + i), copy[i]);
+    bytes = registers.a;
+    return true;
+}
+
+bool serviceMemCmp(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &bytes) {
+    if (!wide(registers)) return false;
+    uint16_t result = 0;
+    uint32_t i = 0;
+    for (; i < registers.a && result == 0; ++i) {
+        const uint8_t left = bus.readByte(dataAddress(registers, registers.x + i));
+        const uint8_t right = bus.readByte(dataAddress(registers, registers.y + i));
+        if (left != right) result = left > right ? 0x0001 : 0xFFFF;
+    }
+    registers.a = result;
+    bytes = i;
+    return true;
+}
+
+bool serviceStrLen(Cpu65816::Registers &registers, SystemBus &bus, uint32_t &bytes) {
+    if (!wide(registers)) return false;
+    uint32_t length = 0;
+    while (length < 0xFFFF && bus.readByte(dataAddress(registers, registers.x + length)) != 0) ++length;
+    registers.a = (uint16_t)length;
+    bytes = length;
+    return true;
+}
+
+} // namespace
+
+HostServices::HostServices() {
+    for (Service &service : mServices) service = Service { 0, 0, 0, 0, 0 };
+
+    // Rough costs of a hardware assist, well under the software routines.
+    add(HOST_MUL32, "mul32", serviceMul32, 20);
+    add(HOST_DIV32, "div32", serviceDiv32, 40);
+    add(HOST_UL2A, "ul2a", serviceUl2a, 40, 1);
+    add(HOST_MEMFILL, "memfill", serviceMemFill, 10, 1);
+    add(HOST_MEMCPY, "memcpy", serviceMemCpy, 10, 2);
+    add(HOST_MEMCMP, "memcmp", serviceMemCmp, 10, 2);
+    add(HOST_STRLEN, "strlen", serviceStrLen, 10, 1);
+}
+
+void HostServices::add(uint8_t signature, const char *name, Handler handler, uint32_t cycles, uint32_t cyclesPerByte) {
+    mServices[signature] = Service { name, handler, cycles, cyclesPerByte, 0 };
+}
+
+void HostServices::remove(uint8_t signature) {
+    mServices[signature] = Service { 0, 0, 0, 0, 0 };
+}
+
+bool HostServices::setCost(uint8_t signature, uint32_t cycles, uint32_t cyclesPerByte) {
+    Service &service = mServices[signature];
+    if (!service.handler) return false;
+    service.cycles = cycles;
+    service.cyclesPerByte = cyclesPerByte;
+    return true;
+}
+
+int HostServices::find(const char *name) const {
+    for (int signature = 0; signature < 256; ++signature) {
+        if (mServices[signature].name && !strcmp(mServices[signature].name, name)) return signature;
+    }
+    return -1;
+}
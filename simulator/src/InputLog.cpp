@@ -0,0 +1,105 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "InputLog.hpp"
+#include "Log.hpp"
+#include "SystemBusDevice.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#define LOG_TAG "InputLog"
+
+InputLog::InputLog() : mReplaying(false) {
+}
+
+bool InputLog::record(const std::string &filename, std::string &error) {
+    mOut.open(filename);
+    if (!mOut) {
+        error = "cannot write " + filename;
+        return false;
+    }
+    mOut << "# dt65pc input log: CYCLE UART BYTE" << std::endl;
+    return true;
+}
+
+bool InputLog::replay(const std::string &filename, std::string &error) {
+    std::ifstream infile(filename);
+    if (!infile) {
+        error = "cannot read " + filename;
+        return false;
+    }
+    mEvents.clear();
+
+    std::string text;
+    for (int line = 1; std::getline(infile, text); ++line) {
+        const size_t hash = text.find('#');
+        if (hash != std::string::npos) text.resize(hash);
+        std::istringstream words(text);
+        std::string cycleText, uartText, valText, extra;
+        if (!(words >> cycleText)) continue;
+
+        char *end;
+        const unsigned long long cycle = strtoull(cycleText.c_str(), &end, 10);
+        const bool cycleOk = *end == '\0';
+        const unsigned long val = words >> uartText >> valText ? strtoul(valText.c_str(), &end, 16) : 0x100;
+        Address uart;
+        if (!cycleOk || valText.empty() || *end != '\0' || val > 0xFF || (words >> extra)
+                || !Address::parse(uartText.c_str(), uart)) {
+            std::ostringstream out;
+            out << filename << ":" << line << ": expected CYCLE UART BYTE";
+            error = out.str();
+            return false;
+        }
+        mEvents[uart.getAbsolute()].events.push_back(Event { cycle, (uint8_t)val });
+    }
+    mReplaying = true;
+    return true;
+}
+
+void InputLog::put(uint32_t uart, uint64_t cycle, uint8_t val) {
+    if (!mOut.is_open()) return;
+    mOut << cycle << " " << std::hex << std::uppercase << std::setfill('0')
+         << std::setw(2) << ((uart >> 16) & 0xFF) << ":" << std::setw(4) << (uart & 0xFFFF) << " "
+         << std::setw(2) << (unsigned)val << std::dec << std::setfill(' ') << std::endl;
+}
+
+int InputLog::take(uint32_t uart, uint64_t cycle) {
+    auto it = mEvents.find(uart);
+    if (it == mEvents.end()) return -1;
+    Stream &stream = it->second;
+    if (stream.next >= stream.events.size() || stream.events[stream.next].cycle > cycle) return -1;
+    const Event event = stream.events[stream.next++];
+    if (event.cycle != cycle) {
+        // The run has diverged from the recorded one; carry on, late.
+        Log::dbg(LOG_TAG).str("Replaying a byte recorded at cycle ").dec(event.cycle)
+            .str(" at ").dec(cycle).show();
+    }
+    return event.val;
+}
+
+size_t InputLog::position(uint32_t uart) const {
+    auto it = mEvents.find(uart);
+    return it == mEvents.end() ? 0 : it->second.next;
+}
+
+void InputLog::seek(uint32_t uart, size_t position) {
+    auto it = mEvents.find(uart);
+    if (it == mEvents.end()) return;
+    it->second.next = position < it->second.events.size() ? position : it->second.events.size();
+}
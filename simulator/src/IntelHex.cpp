@@ -0,0 +1,157 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "IntelHex.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+// Size of the 24-bit address space.
+#define ADDRESS_SPACE_SIZE 0x1000000
+
+// Record types.
+#define HEX_DATA                0x00
+#define HEX_END_OF_FILE         0x01
+#define HEX_EXTENDED_SEGMENT    0x02
+#define HEX_START_SEGMENT       0x03
+#define HEX_EXTENDED_LINEAR     0x04
+#define HEX_START_LINEAR        0x05
+
+namespace {
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+std::string lineError(const std::string &filename, int line, const char *message) {
+    std::ostringstream out;
+    out << filename << ":" << line << ": " << message;
+    return out.str();
+}
+
+} // namespace
+
+bool IntelHex::isHexFile(const std::string &filename) {
+    const size_t dot = filename.rfind('.');
+    if (dot == std::string::npos) return false;
+    std::string extension = filename.substr(dot + 1);
+    for (char &c : extension) c = (char)tolower((unsigned char)c);
+    return extension == "hex";
+}
+
+bool IntelHex::read(const std::string &filename, std::string &error) {
+    mRuns.clear();
+    mHasStart = false;
+    mStart = 0;
+
+    std::ifstream infile(filename);
+    if (!infile) {
+        error = "cannot read " + filename;
+        return false;
+    }
+
+    uint32_t upper = 0;
+    std::string text;
+    uint8_t record[260];
+    for (int line = 1; std::getline(infile, text); ++line) {
+        while (!text.empty() && isspace((unsigned char)text.back())) text.pop_back();
+        if (text.empty()) continue;
+        if (text[0] != ':' || text.size() < 11 || (text.size() & 1) == 0) {
+            error = lineError(filename, line, "not an Intel HEX record");
+            return false;
+        }
+
+        // Byte count, address, type, data and checksum, which makes the
+        // sum of all bytes zero.
+        const size_t length = (text.size() - 1) / 2;
+        if (length > sizeof(record)) {
+            // Longer than any byte count allows, and than the buffer.
+            error = lineError(filename, line, "record length does not match its byte count");
+            return false;
+        }
+        uint8_t sum = 0;
+        for (size_t i = 0; i < length; ++i) {
+            const int high = hexDigit(text[1 + 2 * i]);
+            const int low = hexDigit(text[2 + 2 * i]);
+            if (high < 0 || low < 0) {
+                error = lineError(filename, line, "bad hex digit");
+                return false;
+            }
+            record[i] = (uint8_t)(high << 4 | low);
+            sum += record[i];
+        }
+        if (length != (size_t)record[0] + 5u) {
+            error = lineError(filename, line, "record length does not match its byte count");
+            return false;
+        }
+        if (sum != 0) {
+            error = lineError(filename, line, "bad checksum");
+            return false;
+        }
+
+        const uint8_t count = record[0];
+        const uint32_t offset = (uint32_t)record[1] << 8 | record[2];
+        const uint8_t *data = record + 4;
+        if ((record[3] == HEX_EXTENDED_SEGMENT || record[3] == HEX_EXTENDED_LINEAR) && count != 2) {
+            error = lineError(filename, line, "bad extended address record");
+            return false;
+        }
+        if ((record[3] == HEX_START_SEGMENT || record[3] == HEX_START_LINEAR) && count != 4) {
+            error = lineError(filename, line, "bad start address record");
+            return false;
+        }
+        switch (record[3]) {
+            case HEX_DATA: {
+                const uint64_t address = (uint64_t)upper + offset;
+                if (address + count > ADDRESS_SPACE_SIZE) {
+                    error = lineError(filename, line, "data beyond the address space");
+                    return false;
+                }
+                if (mRuns.empty() || mRuns.back().address + mRuns.back().bytes.size() != address) {
+                    mRuns.push_back(Run { (uint32_t)address, std::vector<uint8_t>() });
+                }
+                mRuns.back().bytes.insert(mRuns.back().bytes.end(), data, data + count);
+                break;
+            }
+            case HEX_END_OF_FILE:
+                return true;
+            case HEX_EXTENDED_SEGMENT:
+                upper = ((uint32_t)data[0] << 8 | data[1]) << 4;
+                break;
+            case HEX_EXTENDED_LINEAR:
+                upper = ((uint32_t)data[0] << 8 | data[1]) << 16;
+                break;
+            case HEX_START_SEGMENT:
+                mHasStart = true;
+                mStart = (((uint32_t)data[0] << 8 | data[1]) << 4) + ((uint32_t)data[2] << 8 | data[3]);
+                break;
+            case HEX_START_LINEAR:
+                mHasStart = true;
+                mStart = (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3];
+                break;
+            default:
+                error = lineError(filename, line, "unknown record type");
+                return false;
+        }
+    }
+    error = filename + " has no end of file record";
+    return false;
+}
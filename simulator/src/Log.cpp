@@ -22,20 +22,23 @@
 
 #define HEX_PREFIX "$"
 
-Log Log::sVerboseLog(true);
-Log Log::sDebugLog(true);
-Log Log::sTraceLog(true);
-Log Log::sErrorLog(true);
+thread_local Log Log::sVerboseLog(true);
+thread_local Log Log::sDebugLog(true);
+thread_local Log Log::sTraceLog(true);
+thread_local Log Log::sErrorLog(true);
 std::ofstream Log::sOut;
+std::mutex Log::sOutMutex;
 
 Log::Log(const bool enabled) : mEnabled(enabled) {
 }
 
 void Log::out(const std::string& fname) {
+    std::lock_guard<std::mutex> lock(sOutMutex);
     sOut = std::ofstream(fname);
 }
 
 void Log::out() {
+    std::lock_guard<std::mutex> lock(sOutMutex);
     if (sOut.is_open()) {
         sOut.close();
     }
@@ -76,12 +79,12 @@ Log &Log::hex(uint32_t val, uint8_t w) {
     return *this;
 }
 
-Log &Log::dec(uint32_t val) {
+Log &Log::dec(uint64_t val) {
     if (mEnabled) mStream << std::dec << val;
     return *this;
 }
 
-Log &Log::dec(uint32_t val, uint8_t w) {
+Log &Log::dec(uint64_t val, uint8_t w) {
     if (mEnabled) mStream << std::setw(w) << std::setfill('0') << val;
     return *this;
 }
@@ -93,6 +96,7 @@ Log &Log::sp() {
 
 void Log::show() {
     if (mEnabled) {
+        std::lock_guard<std::mutex> lock(sOutMutex);
         if (sOut.is_open()) {
             sOut << mTag << ": " << mStream.str() << std::endl;
         } else {
@@ -0,0 +1,144 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Machine.hpp"
+
+#include "DmaController.hpp"
+#include "IntelHex.hpp"
+#include "MathUnit.hpp"
+#include "Ram.hpp"
+#include "Rom.hpp"
+#include "Uart.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// Size of the 24-bit address space.
+#define ADDRESS_SPACE_SIZE 0x1000000
+
+const char *stopReasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::Stp:           return "stp";
+        case StopReason::Breakpoint:    return "breakpoint";
+        case StopReason::Watchpoint:    return "watchpoint";
+        case StopReason::CycleBudget:   return "cycle budget";
+        case StopReason::DeviceRequest: return "device request";
+        case StopReason::Unimplemented: return "unimplemented opcode";
+        case StopReason::HistoryStart:  return "start of history";
+    }
+    return "unknown";
+}
+
+Machine::Machine() : mCpu(mSystemBus) {
+}
+
+Machine &Machine::addRom(const Address &base, const std::string &filename) {
+    return addDevice(std::unique_ptr<SystemBusDevice>(new Rom(base, filename)));
+}
+
+Machine &Machine::addUart(const Address &base, Terminal *term) {
+    return addDevice(std::unique_ptr<SystemBusDevice>(new UartPC16550D(base, term)));
+}
+
+Machine &Machine::addMathUnit(const Address &base) {
+    return addDevice(std::unique_ptr<SystemBusDevice>(new MathUnit(base)));
+}
+
+Machine &Machine::addDma(const Address &base) {
+    return addDevice(std::unique_ptr<SystemBusDevice>(new DmaController(base, mSystemBus)));
+}
+
+Machine &Machine::addRam(uint16_t banks) {
+    return addDevice(std::unique_ptr<SystemBusDevice>(new Ram(banks)));
+}
+
+Machine &Machine::addDevice(SystemBusDevice *device) {
+    mSystemBus.registerDevice(device);
+    return *this;
+}
+
+Machine &Machine::addDevice(std::unique_ptr<SystemBusDevice> device) {
+    mDevices.push_back(std::move(device));
+    return addDevice(mDevices.back().get());
+}
+
+bool Machine::load(const std::string &filename, uint32_t address, std::string &error) {
+    address &= 0xFFFFFF;
+    if (IntelHex::isHexFile(filename)) {
+        IntelHex hex;
+        if (!hex.read(filename, error)) return false;
+        for (const IntelHex::Run &run : hex.runs()) {
+            if ((uint64_t)address + run.address + run.bytes.size() > ADDRESS_SPACE_SIZE) {
+                error = filename + " does not fit below the end of memory";
+                return false;
+            }
+        }
+        for (const IntelHex::Run &run : hex.runs()) {
+            mSystemBus.storeBytes(address + run.address, run.bytes.data(), (uint32_t)run.bytes.size());
+        }
+        return true;
+    }
+
+    std::ifstream infile(filename, std::ios::binary);
+    if (!infile) {
+        error = "cannot read " + filename;
+        return false;
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+    if ((uint64_t)address + bytes.size() > ADDRESS_SPACE_SIZE) {
+        error = filename + " does not fit below the end of memory";
+        return false;
+    }
+    mSystemBus.storeBytes(address, bytes.data(), (uint32_t)bytes.size());
+    return true;
+}
+
+void Machine::reset() {
+    mSystemBus.clearStopRequest();
+    mCpu.setRESPin(true);
+    mCpu.setRESPin(false);
+}
+
+StopReason Machine::run(uint64_t maxCycles, unsigned stopConditions) {
+    const uint64_t start = mCpu.getTotalCycles();
+    const uint64_t limit = maxCycles > UINT64_MAX - start ? UINT64_MAX : start + maxCycles;
+    const bool breakPoints = (stopConditions & STOP_ON_BREAKPOINT) && !mBreakPoints.empty();
+    const bool watchPoints = (stopConditions & STOP_ON_WATCHPOINT) != 0;
+    const bool deviceRequests = (stopConditions & STOP_ON_DEVICE) != 0;
+    Watchpoints &watchpoints = mSystemBus.watchpoints();
+
+    while (mCpu.getTotalCycles() < limit) {
+        if (!mCpu.executeNextInstruction() || mCpu.isStopped()) {
+            return mCpu.isStopped() ? StopReason::Stp : StopReason::Unimplemented;
+        }
+        if (breakPoints) {
+            const uint32_t programAddress = mCpu.getProgramAddress().getAbsolute();
+            if (mBreakPoints.isSet(programAddress) && mBreakPoints.hit(programAddress)) {
+                return StopReason::Breakpoint;
+            }
+        }
+        if (watchPoints && watchpoints.hasHits()) {
+            return StopReason::Watchpoint;
+        }
+        if (deviceRequests && mSystemBus.stopRequested()) {
+            mSystemBus.clearStopRequest();
+            return StopReason::DeviceRequest;
+        }
+    }
+    return StopReason::CycleBudget;
+}
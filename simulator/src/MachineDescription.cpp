@@ -0,0 +1,266 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "MachineDescription.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "BlockDevice.hpp"
+#include "DmaController.hpp"
+#include "MathUnit.hpp"
+#include "Ram.hpp"
+#include "Rom.hpp"
+#include "Uart.hpp"
+
+// Registers of a PC16550D.
+#define UART_SIZE 8
+
+// Registers of the math coprocessor.
+#define MATH_UNIT_SIZE 0x20
+
+// Registers of the DMA controller.
+#define DMA_CONTROLLER_SIZE 0x10
+
+// Registers and sector window of a block device.
+#define BLOCK_DEVICE_SIZE 0x400
+
+namespace {
+
+const char *kindName(MachineDescription::DeviceKind kind) {
+    switch (kind) {
+        case MachineDescription::DeviceKind::Rom:       return "rom";
+        case MachineDescription::DeviceKind::Uart:      return "uart";
+        case MachineDescription::DeviceKind::MathUnit:  return "mathunit";
+        case MachineDescription::DeviceKind::Dma:       return "dma";
+        case MachineDescription::DeviceKind::Disk:      return "disk";
+        case MachineDescription::DeviceKind::Ram:       return "ram";
+    }
+    return "device";
+}
+
+bool parseNumber(const std::string &text, uint32_t &out) {
+    if (text.empty()) return false;
+    char *end;
+    const unsigned long value = strtoul(text.c_str(), &end, 0);
+    if (*end != '\0' || value > 0xFFFFFFFF) return false;
+    out = (uint32_t)value;
+    return true;
+}
+
+bool isAbsolute(const std::string &path) {
+    return (!path.empty() && (path[0] == '/' || path[0] == '\\'))
+        || (path.size() > 1 && path[1] == ':');
+}
+
+std::string directoryOf(const std::string &filename) {
+    const size_t slash = filename.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : filename.substr(0, slash + 1);
+}
+
+std::string lineError(const std::string &filename, int line, const std::string &message) {
+    std::ostringstream out;
+    out << filename << ":" << line << ": " << message;
+    return out.str();
+}
+
+} // namespace
+
+bool MachineDescription::load(const std::string &filename, std::string &error) {
+    std::ifstream infile(filename);
+    if (!infile) {
+        error = "cannot read " + filename;
+        return false;
+    }
+    mDevices.clear();
+    const std::string directory = directoryOf(filename);
+
+    std::string text;
+    bool haveRam = false;
+    for (int line = 1; std::getline(infile, text); ++line) {
+        const size_t hash = text.find('#');
+        if (hash != std::string::npos) text.resize(hash);
+        std::istringstream words(text);
+        std::vector<std::string> args;
+        for (std::string word; words >> word; ) args.push_back(word);
+        if (args.empty()) continue;
+
+        const std::string &keyword = args[0];
+        if (keyword == "clock") {
+            if (args.size() != 2 || !parseNumber(args[1], mClock) || mClock == 0) {
+                error = lineError(filename, line, "expected clock HZ");
+                return false;
+            }
+        } else if (keyword == "mode") {
+            if (args.size() != 2 || (args[1] != "trace" && args[1] != "quiet")) {
+                error = lineError(filename, line, "expected mode trace|quiet");
+                return false;
+            }
+            mTrace = args[1] == "trace";
+        } else if (keyword == "rom") {
+            Address base;
+            uint32_t size = 0;
+            if (args.size() < 3 || args.size() > 4 || !Address::parse(args[1].c_str(), base)
+                    || (args.size() == 4 && (!parseNumber(args[3], size) || size == 0))) {
+                error = lineError(filename, line, "expected rom ADDRESS IMAGE [SIZE]");
+                return false;
+            }
+            const std::string path = isAbsolute(args[2]) ? args[2] : directory + args[2];
+            mDevices.push_back(Device { DeviceKind::Rom, base.getAbsolute(), size, path, false, line });
+        } else if (keyword == "uart") {
+            Address base;
+            if (args.size() < 2 || args.size() > 3 || !Address::parse(args[1].c_str(), base)
+                    || (args.size() == 3 && args[2] != "console" && args[2] != "none")) {
+                error = lineError(filename, line, "expected uart ADDRESS [console|none]");
+                return false;
+            }
+            const bool console = args.size() == 3 && args[2] == "console";
+            mDevices.push_back(Device { DeviceKind::Uart, base.getAbsolute(), UART_SIZE, "", console, line });
+        } else if (keyword == "mathunit") {
+            Address base;
+            if (args.size() != 2 || !Address::parse(args[1].c_str(), base)) {
+                error = lineError(filename, line, "expected mathunit ADDRESS");
+                return false;
+            }
+            mDevices.push_back(Device { DeviceKind::MathUnit, base.getAbsolute(), MATH_UNIT_SIZE, "", false, line });
+        } else if (keyword == "dma") {
+            Address base;
+            if (args.size() != 2 || !Address::parse(args[1].c_str(), base)) {
+                error = lineError(filename, line, "expected dma ADDRESS");
+                return false;
+            }
+            mDevices.push_back(Device { DeviceKind::Dma, base.getAbsolute(), DMA_CONTROLLER_SIZE, "", false, line });
+        } else if (keyword == "disk") {
+            Address base;
+            if (args.size() != 3 || !Address::parse(args[1].c_str(), base)) {
+                error = lineError(filename, line, "expected disk ADDRESS IMAGE");
+                return false;
+            }
+            const std::string path = isAbsolute(args[2]) ? args[2] : directory + args[2];
+            mDevices.push_back(Device { DeviceKind::Disk, base.getAbsolute(), BLOCK_DEVICE_SIZE, path, false, line });
+        } else if (keyword == "ram") {
+            uint32_t banks;
+            if (args.size() != 2 || !parseNumber(args[1], banks) || banks == 0 || banks > 0x100) {
+                error = lineError(filename, line, "expected ram BANKS, from 1 to 0x100");
+                return false;
+            }
+            if (haveRam) {
+                error = lineError(filename, line, "only one ram is allowed");
+                return false;
+            }
+            haveRam = true;
+            mDevices.push_back(Device { DeviceKind::Ram, 0, banks * BANK_SIZE_BYTES, "", false, line });
+        } else {
+            error = lineError(filename, line, "unknown keyword " + keyword);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MachineDescription::build(Machine &machine, Terminal *console, std::string &error, InputLog *input) const {
+    struct Placed {
+        const Device *device;
+        std::unique_ptr<SystemBusDevice> instance;
+        uint32_t first;
+        uint32_t size;
+    };
+    std::vector<Placed> placed;
+
+    for (const Device &device : mDevices) {
+        std::unique_ptr<SystemBusDevice> instance;
+        switch (device.kind) {
+            case DeviceKind::Rom: {
+                std::shared_ptr<const RomImage> image = RomImage::open(device.path, error);
+                if (!image) return false;
+                instance.reset(new Rom(Address((device.base >> 16) & 0xFF, device.base & 0xFFFF), image));
+                break;
+            }
+            case DeviceKind::Uart: {
+                std::unique_ptr<UartPC16550D> uart(new UartPC16550D(
+                    Address((device.base >> 16) & 0xFF, device.base & 0xFFFF), device.console ? console : 0));
+                uart->setInputLog(input);
+                instance = std::move(uart);
+                break;
+            }
+            case DeviceKind::MathUnit:
+                instance.reset(new MathUnit(Address((device.base >> 16) & 0xFF, device.base & 0xFFFF)));
+                break;
+            case DeviceKind::Dma:
+                instance.reset(new DmaController(Address((device.base >> 16) & 0xFF, device.base & 0xFFFF),
+                    machine.bus()));
+                break;
+            case DeviceKind::Disk: {
+                std::unique_ptr<BlockDevice> disk(new BlockDevice(
+                    Address((device.base >> 16) & 0xFF, device.base & 0xFFFF), machine.bus()));
+                if (!disk->attach(device.path, error)) return false;
+                instance = std::move(disk);
+                break;
+            }
+            case DeviceKind::Ram:
+                instance.reset(new Ram((uint16_t)(device.size / BANK_SIZE_BYTES)));
+                break;
+        }
+
+        uint32_t first, size;
+        instance->getAddressRange(first, size);
+        if (device.size) {
+            if (size > device.size) {
+                std::ostringstream out;
+                out << device.path << " is " << size << " bytes, more than the " << device.size << " reserved";
+                error = out.str();
+                return false;
+            }
+            size = device.size;
+        }
+        if ((uint64_t)first + size > 0x1000000) {
+            std::ostringstream out;
+            out << kindName(device.kind) << " on line " << device.line << " runs past the end of memory";
+            error = out.str();
+            return false;
+        }
+        placed.push_back(Placed { &device, std::move(instance), first, size });
+    }
+
+    // RAM lies beneath everything else, which shadows it; any other
+    // overlap is a mistake.
+    for (size_t i = 0; i < placed.size(); ++i) {
+        for (size_t j = i + 1; j < placed.size(); ++j) {
+            const Placed &a = placed[i];
+            const Placed &b = placed[j];
+            if (a.device->kind == DeviceKind::Ram || b.device->kind == DeviceKind::Ram) continue;
+            if (a.first < b.first + b.size && b.first < a.first + a.size) {
+                std::ostringstream out;
+                out << kindName(b.device->kind) << " on line " << b.device->line << " overlaps "
+                    << kindName(a.device->kind) << " on line " << a.device->line;
+                error = out.str();
+                return false;
+            }
+        }
+    }
+
+    // Decoding on the bus is first come, first served, so RAM goes last.
+    for (Placed &entry : placed) {
+        if (entry.device->kind != DeviceKind::Ram) machine.addDevice(std::move(entry.instance));
+    }
+    for (Placed &entry : placed) {
+        if (entry.device->kind == DeviceKind::Ram) machine.addDevice(std::move(entry.instance));
+    }
+    return true;
+}
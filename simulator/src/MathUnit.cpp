@@ -0,0 +1,216 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "MathUnit.hpp"
+#include "DeviceState.hpp"
+#include "Log.hpp"
+#include "Metrics.hpp"
+
+#define LOG_TAG "MathUnit"
+
+// Bytes of register file.
+#define MATH_SIZE 0x20
+
+// Bytes of the remainder register. A square root remainder can be as
+// large as twice the root, one bit more than 32.
+#define REMAINDER_SIZE 5
+
+// Latencies in CPU cycles, roughly one cycle per result bit for the
+// iterative operations.
+#define MUL_CYCLES 16
+#define DIV_CYCLES 34
+#define SQRT_CYCLES 34
+#define BCD_CYCLES 12
+
+namespace {
+
+uint8_t byteOf(uint64_t value, int index) {
+    return (uint8_t)(value >> (8 * index));
+}
+
+void setByte(uint64_t &value, int index, uint8_t val) {
+    value = (value & ~((uint64_t)0xFF << (8 * index))) | ((uint64_t)val << (8 * index));
+}
+
+uint32_t isqrt(uint64_t value) {
+    // Digit by digit, two bits of the operand per bit of the root.
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > value) bit >>= 2;
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+} // namespace
+
+MathUnit::MathUnit(const Address &baseAddr) : mBase(baseAddr.getAbsolute()),
+                                              mOperandA(0),
+                                              mOperandB(0),
+                                              mResult(0),
+                                              mRemainder(0),
+                                              mPendingResult(0),
+                                              mPendingRemainder(0),
+                                              mStatus(0),
+                                              mCyclesLeft(0) {
+}
+
+void MathUnit::storeByte(const Address &addr, uint8_t val) {
+    const uint16_t reg = addr.getOffset();
+    if (reg < MATH_OPB) {
+        setByte(mOperandA, reg - MATH_OPA, val);
+    } else if (reg < MATH_OPB + 4) {
+        uint64_t b = mOperandB;
+        setByte(b, reg - MATH_OPB, val);
+        mOperandB = (uint32_t)b;
+    } else if (reg == MATH_CONTROL) {
+        start(val);
+    }
+}
+
+uint8_t MathUnit::readByte(const Address &addr) {
+    const uint16_t reg = addr.getOffset();
+    if (reg < MATH_OPB) return byteOf(mOperandA, reg - MATH_OPA);
+    if (reg < MATH_OPB + 4) return byteOf(mOperandB, reg - MATH_OPB);
+    if (reg >= MATH_RESULT && reg < MATH_RESULT + 8) return byteOf(mResult, reg - MATH_RESULT);
+    if (reg >= MATH_REMAINDER && reg < MATH_REMAINDER + REMAINDER_SIZE) return byteOf(mRemainder, reg - MATH_REMAINDER);
+    if (reg == MATH_CONTROL) return mStatus;
+    return 0;
+}
+
+bool MathUnit::decodeAddress(const Address &in, Address &out) {
+    uint32_t addr = in.getAbsolute() - mBase;
+    out = Address((addr >> 16) & 0xFF, addr & 0xFFFF);
+    return addr < MATH_SIZE;
+}
+
+bool MathUnit::getAddressRange(uint32_t &first, uint32_t &size) {
+    first = mBase;
+    size = MATH_SIZE;
+    return true;
+}
+
+void MathUnit::addCycles(int cycles) {
+    if (!(mStatus & MATH_BUSY)) return;
+    mCyclesLeft -= cycles;
+    if (mCyclesLeft <= 0) complete();
+}
+
+void MathUnit::saveState(DeviceState &state) {
+    state.put(mOperandA);
+    state.put(mOperandB);
+    state.put(mResult);
+    state.put(mRemainder);
+    state.put(mPendingResult);
+    state.put(mPendingRemainder);
+    state.put(mStatus);
+    state.put(mCyclesLeft);
+}
+
+void MathUnit::restoreState(DeviceState &state) {
+    mOperandA = state.get<uint64_t>();
+    mOperandB = state.get<uint32_t>();
+    mResult = state.get<uint64_t>();
+    mRemainder = state.get<uint64_t>();
+    mPendingResult = state.get<uint64_t>();
+    mPendingRemainder = state.get<uint64_t>();
+    mStatus = state.get<uint8_t>();
+    mCyclesLeft = state.get<int>();
+}
+
+void MathUnit::addMetrics(MetricsGroup &group) {
+    group.setKind("mathunit");
+}
+
+int MathUnit::latency(uint8_t command) {
+    switch (command) {
+        case MATH_MUL:      return MUL_CYCLES;
+        case MATH_DIV:      return DIV_CYCLES;
+        case MATH_SQRT:     return SQRT_CYCLES;
+        case MATH_BIN2BCD:
+        case MATH_BCD2BIN:  return BCD_CYCLES;
+    }
+    return 0;
+}
+
+void MathUnit::start(uint8_t command) {
+    bool error = false;
+    uint64_t result = 0;
+    uint64_t remainder = 0;
+
+    switch (command) {
+        case MATH_MUL:
+            result = (mOperandA & 0xFFFFFFFF) * mOperandB;
+            break;
+
+        case MATH_DIV:
+            if (mOperandB) {
+                result = mOperandA / mOperandB;
+                remainder = mOperandA % mOperandB;
+            } else {
+                error = true;
+            }
+            break;
+
+        case MATH_SQRT:
+            result = isqrt(mOperandA);
+            remainder = mOperandA - result * result;
+            break;
+
+        case MATH_BIN2BCD: {
+            uint32_t value = (uint32_t)mOperandA;
+            for (int shift = 0; value; shift += 4) {
+                result |= (uint64_t)(value % 10) << shift;
+                value /= 10;
+            }
+            break;
+        }
+
+        case MATH_BCD2BIN:
+            for (int shift = 36; shift >= 0; shift -= 4) {
+                const unsigned digit = (mOperandA >> shift) & 0xF;
+                if (digit > 9) error = true;
+                result = result * 10 + digit;
+            }
+            if (result > 0xFFFFFFFF) error = true;
+            if (error) result = 0;
+            break;
+
+        default:
+            Log::trc(LOG_TAG).str("Ignoring command ").hex(command, 2).show();
+            return;
+    }
+
+    mPendingResult = result;
+    mPendingRemainder = remainder;
+    mStatus = command | MATH_BUSY | (error ? MATH_ERROR : 0);
+    mCyclesLeft = latency(command);
+}
+
+void MathUnit::complete() {
+    mResult = mPendingResult;
+    mRemainder = mPendingRemainder;
+    mStatus &= ~MATH_BUSY;
+    mCyclesLeft = 0;
+}
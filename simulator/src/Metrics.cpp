@@ -0,0 +1,182 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Metrics.hpp"
+#include "Machine.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// A reader that goes away should stop the exports, not the process.
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define NO_SOCKET ((intptr_t)-1)
+
+CounterSlots::CounterSlots(size_t count) : mBase(0), mCount(0) {
+    resize(count);
+}
+
+void CounterSlots::resize(size_t count) {
+    // One spare line's worth of words to align the first counter.
+    std::vector<uint64_t> storage(count * SLOT_WORDS + SLOT_WORDS, 0);
+    uint64_t *base = storage.data();
+    while ((uintptr_t)base % METRICS_CACHE_LINE) ++base;
+    for (size_t i = 0; i < count && i < mCount; ++i) {
+        base[i * SLOT_WORDS] = mBase[i * SLOT_WORDS];
+    }
+    mStorage.swap(storage);
+    mBase = base;
+    mCount = count;
+}
+
+void MetricsGroup::add(const char *name, uint64_t value) {
+    mValues.push_back(std::make_pair(name, std::to_string(value)));
+}
+
+void MetricsGroup::add(const char *name, double value) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3) << value;
+    mValues.push_back(std::make_pair(name, out.str()));
+}
+
+void MetricsGroup::write(std::ostream &out) const {
+    for (size_t i = 0; i < mValues.size(); ++i) {
+        if (i) out << ",";
+        out << "\"" << mValues[i].first << "\":" << mValues[i].second;
+    }
+}
+
+Metrics::Metrics(Machine &machine) : mMachine(machine),
+                                     mSocket(NO_SOCKET),
+                                     mStart(Clock::now()),
+                                     mLastWrite(mStart),
+                                     mInterval(0) {
+}
+
+Metrics::~Metrics() {
+#ifndef _WIN32
+    if (mSocket != NO_SOCKET) close((int)mSocket);
+#endif
+}
+
+bool Metrics::open(const std::string &target, std::string &error) {
+    mTarget = target;
+#ifndef _WIN32
+    struct stat status;
+    if (stat(target.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (target.size() >= sizeof(address.sun_path)) {
+            error = "socket path too long: " + target;
+            return false;
+        }
+        strcpy(address.sun_path, target.c_str());
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, (const sockaddr *)&address, sizeof(address)) != 0) {
+            if (fd >= 0) close(fd);
+            error = "cannot connect to " + target;
+            return false;
+        }
+        mSocket = fd;
+    }
+#endif
+    return true;
+}
+
+void Metrics::poll() {
+    const Clock::time_point now = Clock::now();
+    if (!periodic() || now - mLastWrite < mInterval) return;
+    mLastWrite = now;
+    write();
+}
+
+bool Metrics::write() {
+    std::ostringstream out;
+    write(out);
+    const std::string text = out.str();
+
+#ifndef _WIN32
+    if (mSocket != NO_SOCKET) {
+        if (send((int)mSocket, text.data(), text.size(), MSG_NOSIGNAL) == (ssize_t)text.size()) return true;
+        close((int)mSocket);
+        mSocket = NO_SOCKET;
+        mTarget.clear();
+        return false;
+    }
+#endif
+    if (mTarget.empty()) return false;
+
+    // Replace the file whole so a reader never sees half an export.
+    const std::string temporary = mTarget + ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (!(file << text)) return false;
+    }
+#ifdef _WIN32
+    std::remove(mTarget.c_str());
+#endif
+    return std::rename(temporary.c_str(), mTarget.c_str()) == 0;
+}
+
+void Metrics::write(std::ostream &out) const {
+    Cpu65816 &cpu = mMachine.cpu();
+    SystemBus &bus = mMachine.bus();
+    const double seconds = std::chrono::duration<double>(Clock::now() - mStart).count();
+
+    MetricsGroup machine;
+    machine.add("instructions", cpu.getTotalInstructions());
+    machine.add("cycles", cpu.getTotalCycles());
+    machine.add("seconds", seconds);
+    machine.add("mhz", seconds > 0 ? cpu.getTotalCycles() / seconds / 1e6 : 0.0);
+    machine.add("interrupts", cpu.getInterruptsTaken());
+    machine.add("wai", cpu.getWaits());
+
+    out << "{";
+    machine.write(out);
+    out << ",\"devices\":{";
+    const std::vector<SystemBusDevice *> &devices = bus.devices();
+    for (size_t i = 0; i < devices.size(); ++i) {
+        MetricsGroup group;
+        group.add("reads", bus.deviceReads(i));
+        group.add("writes", bus.deviceWrites(i));
+        devices[i]->addMetrics(group);
+
+        // Named for the kind and base address, which tell devices apart.
+        uint32_t first = 0, size;
+        devices[i]->getAddressRange(first, size);
+        std::ostringstream name;
+        name << group.kind() << "@" << std::hex << std::uppercase << std::setfill('0')
+             << std::setw(2) << (first >> 16) << ":" << std::setw(4) << (first & 0xFFFF);
+        if (i) out << ",";
+        out << "\"" << name.str() << "\":{";
+        group.write(out);
+        out << "}";
+    }
+    out << "}}" << std::endl;
+}
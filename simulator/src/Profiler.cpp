@@ -0,0 +1,101 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <string>
+
+// Number of 256-byte pages in the 24-bit address space.
+#define PAGE_COUNT 0x10000
+
+namespace {
+
+struct Line {
+    std::string name;
+    uint64_t count;
+    uint64_t cycles;
+};
+
+void writeSection(std::ostream &out, const char *title, std::vector<Line> &lines,
+                  uint64_t totalCycles, size_t limit) {
+    std::sort(lines.begin(), lines.end(),
+        [](const Line &a, const Line &b) { return a.cycles > b.cycles; });
+
+    out << title << std::endl;
+    out << std::setw(14) << "cycles" << std::setw(8) << "%" << std::setw(14) << "instructions"
+        << "  location" << std::endl;
+    for (size_t i = 0; i < lines.size() && i < limit; ++i) {
+        const Line &line = lines[i];
+        const double percent = totalCycles ? 100.0 * line.cycles / totalCycles : 0.0;
+        out << std::setw(14) << line.cycles
+            << std::setw(8) << std::fixed << std::setprecision(2) << percent
+            << std::setw(14) << line.count << "  " << line.name << std::endl;
+    }
+    out << std::endl;
+}
+
+} // namespace
+
+Profiler::Profiler() : mPages(PAGE_COUNT, nullptr) {
+}
+
+void Profiler::clear() {
+    mPages.assign(PAGE_COUNT, nullptr);
+    mStorage.clear();
+}
+
+Profiler::Counter *Profiler::allocatePage(uint32_t page) {
+    mStorage.emplace_back(new Counter[PAGE_SIZE_BYTES]());
+    mPages[page] = mStorage.back().get();
+    return mPages[page];
+}
+
+void Profiler::report(std::ostream &out, const Symbols &symbols, size_t limit) const {
+    std::vector<Line> addresses;
+    std::map<std::string, Line> routines;
+    uint64_t totalCycles = 0;
+    uint64_t totalCount = 0;
+
+    for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+        const Counter *counters = mPages[page];
+        if (!counters) continue;
+        for (uint32_t i = 0; i < PAGE_SIZE_BYTES; ++i) {
+            const Counter &counter = counters[i];
+            if (counter.count == 0) continue;
+            const uint32_t address = (page << 8) | i;
+            totalCycles += counter.cycles;
+            totalCount += counter.count;
+            addresses.push_back(Line { symbols.describe(address), counter.count, counter.cycles });
+
+            const std::string routine = symbols.routine(address);
+            Line &line = routines[routine];
+            line.name = routine;
+            line.count += counter.count;
+            line.cycles += counter.cycles;
+        }
+    }
+
+    out << "Total: " << totalCycles << " cycles, " << totalCount << " instructions" << std::endl << std::endl;
+
+    std::vector<Line> routineLines;
+    for (const auto &entry : routines) routineLines.push_back(entry.second);
+    writeSection(out, "Time by routine:", routineLines, totalCycles, limit);
+    writeSection(out, "Hottest addresses:", addresses, totalCycles, limit);
+}
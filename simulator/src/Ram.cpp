@@ -17,8 +17,9 @@
 // You should have received a copy of the GNU General Public License
 // along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
 #include "Ram.hpp"
+#include "Metrics.hpp"
 
-Ram::Ram(uint8_t banks) : mBanks(banks) {
+Ram::Ram(uint16_t banks) : mBanks(banks) {
     mRam = new uint8_t[banks * BANK_SIZE_BYTES];
 }
 
@@ -38,3 +39,17 @@ bool Ram::decodeAddress(const Address &in, Address &out) {
     out = in;
     return in.getBank() < mBanks;
 }
+
+bool Ram::getAddressRange(uint32_t &first, uint32_t &size) {
+    first = 0;
+    size = mBanks * BANK_SIZE_BYTES;
+    return true;
+}
+
+uint8_t *Ram::getPagePointer(const Address &address, bool write) {
+    return &mRam[address.getBank() * BANK_SIZE_BYTES + address.getOffset()];
+}
+
+void Ram::addMetrics(MetricsGroup &group) {
+    group.setKind("ram");
+}
@@ -0,0 +1,180 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Rewind.hpp"
+
+#include <cstring>
+
+Rewind::Rewind(Machine &machine, uint64_t interval, size_t ringSize) : mMachine(machine),
+                                                                       mInterval(interval ? interval : 1),
+                                                                       mRingSize(ringSize ? ringSize : 1),
+                                                                       mNextCheckpoint(0) {
+    mMachine.bus().setPageObserver(this);
+}
+
+Rewind::~Rewind() {
+    mMachine.bus().setPageObserver(0);
+}
+
+StopReason Rewind::run(uint64_t maxCycles, unsigned stopConditions) {
+    Cpu65816 &cpu = mMachine.cpu();
+    const uint64_t start = cpu.getTotalCycles();
+    const uint64_t limit = maxCycles > UINT64_MAX - start ? UINT64_MAX : start + maxCycles;
+
+    // Run in slices that end at checkpoints.
+    for (;;) {
+        const uint64_t cycles = cpu.getTotalCycles();
+        if (cycles >= limit) return StopReason::CycleBudget;
+        if (cycles >= mNextCheckpoint) checkpoint();
+        const uint64_t end = mNextCheckpoint < limit ? mNextCheckpoint : limit;
+        const StopReason reason = mMachine.run(end - cycles, stopConditions);
+        if (reason != StopReason::CycleBudget) return reason;
+    }
+}
+
+bool Rewind::stepBack() {
+    const uint64_t instructions = mMachine.cpu().getTotalInstructions();
+    return instructions > 0 && goTo(instructions - 1);
+}
+
+StopReason Rewind::continueBack() {
+    Cpu65816 &cpu = mMachine.cpu();
+    BreakpointSet &breakPoints = mMachine.breakPoints();
+    Watchpoints &watchpoints = mMachine.bus().watchpoints();
+    const uint64_t now = cpu.getTotalInstructions();
+
+    // Replay each interval in turn, newest first, looking for the last
+    // stop in it.
+    long index = find(now > 0 ? now - 1 : 0);
+    uint64_t end = now;
+    while (index >= 0) {
+        restore((size_t)index);
+        watchpoints.clearHits();
+        uint64_t found = UINT64_MAX;
+        StopReason reason = StopReason::Breakpoint;
+        while (cpu.getTotalInstructions() < end) {
+            if (breakPoints.isSet(cpu.getProgramAddress().getAbsolute())) {
+                found = cpu.getTotalInstructions();
+                reason = StopReason::Breakpoint;
+            }
+            if (!cpu.executeNextInstruction()) break;
+            if (watchpoints.hasHits()) {
+                if (cpu.getTotalInstructions() < now) {
+                    found = cpu.getTotalInstructions();
+                    reason = StopReason::Watchpoint;
+                }
+                watchpoints.clearHits();
+            }
+        }
+        if (found < now) {
+            restore((size_t)index);
+            if (reason == StopReason::Watchpoint) {
+                // Execute the triggering instruction last, keeping its hits.
+                stepTo(found - 1);
+                cpu.executeNextInstruction();
+            } else {
+                stepTo(found);
+            }
+            return reason;
+        }
+        end = mRing[(size_t)index].cpu.instructions;
+        --index;
+    }
+
+    // Nothing earlier: stay at the oldest point kept.
+    if (!mRing.empty()) restore(0);
+    return StopReason::HistoryStart;
+}
+
+bool Rewind::goTo(uint64_t instruction) {
+    if (instruction > mMachine.cpu().getTotalInstructions()) return false;
+    const long index = find(instruction);
+    if (index < 0) return false;
+    restore((size_t)index);
+    stepTo(instruction);
+    return true;
+}
+
+size_t Rewind::savedBytes() const {
+    size_t bytes = 0;
+    for (const Checkpoint &checkpoint : mRing) {
+        bytes += checkpoint.pages.size() * sizeof(SavedPage);
+    }
+    return bytes;
+}
+
+void Rewind::beforeFirstWrite(uint32_t page, uint8_t *memory) {
+    if (mRing.empty()) return;
+    mRing.back().pages.emplace_back();
+    SavedPage &saved = mRing.back().pages.back();
+    saved.memory = memory;
+    memcpy(saved.bytes, memory, PAGE_SIZE_BYTES);
+}
+
+void Rewind::checkpoint() {
+    if (mRing.size() >= mRingSize) mRing.pop_front();
+    mRing.emplace_back();
+    Checkpoint &checkpoint = mRing.back();
+    checkpoint.cpu = mMachine.cpu().getSnapshot();
+    for (SystemBusDevice *device : mMachine.bus().devices()) {
+        checkpoint.devices.emplace_back();
+        device->saveState(checkpoint.devices.back());
+    }
+    mMachine.bus().protectPages();
+    mNextCheckpoint = checkpoint.cpu.cycles + mInterval;
+}
+
+long Rewind::find(uint64_t instruction) const {
+    for (long index = (long)mRing.size() - 1; index >= 0; --index) {
+        if (mRing[(size_t)index].cpu.instructions <= instruction) return index;
+    }
+    return -1;
+}
+
+void Rewind::restore(size_t index) {
+    // Newest first, so the oldest copy of a page, from the checkpoint
+    // being restored or the first one after it, is written last. A page
+    // remapped within an interval can be saved twice in one checkpoint.
+    for (size_t i = mRing.size(); i-- > index; ) {
+        const std::vector<SavedPage> &pages = mRing[i].pages;
+        for (auto page = pages.rbegin(); page != pages.rend(); ++page) {
+            memcpy(page->memory, page->bytes, PAGE_SIZE_BYTES);
+        }
+    }
+    mRing.resize(index + 1);
+
+    Checkpoint &checkpoint = mRing.back();
+    checkpoint.pages.clear();
+    mMachine.cpu().restoreSnapshot(checkpoint.cpu);
+    const std::vector<SystemBusDevice *> &devices = mMachine.bus().devices();
+    for (size_t i = 0; i < devices.size() && i < checkpoint.devices.size(); ++i) {
+        checkpoint.devices[i].rewind();
+        devices[i]->restoreState(checkpoint.devices[i]);
+    }
+    mMachine.bus().protectPages();
+    mMachine.bus().watchpoints().clearHits();
+    mMachine.bus().clearStopRequest();
+    mNextCheckpoint = checkpoint.cpu.cycles + mInterval;
+}
+
+void Rewind::stepTo(uint64_t instruction) {
+    Cpu65816 &cpu = mMachine.cpu();
+    while (cpu.getTotalInstructions() < instruction) {
+        if (!cpu.executeNextInstruction()) break;
+    }
+    mMachine.bus().watchpoints().clearHits();
+}
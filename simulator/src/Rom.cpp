@@ -16,19 +16,26 @@
 // along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
 #include "Rom.hpp"
 #include "Log.hpp"
-
-#include <fstream>
+#include "Metrics.hpp"
 
 #define LOG_TAG "ROM"
 
 Rom::Rom(const Address& baseAddr, const std::string& filename)
-        : mBase(baseAddr.getAbsolute()) {
-    std::ifstream infile(filename, std::ios_base::binary);
-    std::copy(std::istreambuf_iterator<char>(infile),
-              std::istreambuf_iterator<char>(),
-              std::back_inserter(mRom));
+        : mBase(baseAddr.getAbsolute()), mRom(0), mSize(0) {
+    std::string error;
+    mImage = RomImage::open(filename, error);
+    if (!mImage) {
+        Log::err(LOG_TAG).str(error.c_str()).show();
+        return;
+    }
+    mRom = mImage->data();
+    mSize = mImage->size();
     Log::dbg(LOG_TAG).str("Initialized ROM from ").str(filename.c_str())
-        .str(" with size ").hex(mRom.size(), 6).show();
+        .str(" with size ").hex(mSize, 6).show();
+}
+
+Rom::Rom(const Address& baseAddr, std::shared_ptr<const RomImage> image)
+        : mBase(baseAddr.getAbsolute()), mImage(image), mRom(image->data()), mSize(image->size()) {
 }
 
 Rom::~Rom() {
@@ -41,5 +48,23 @@ uint8_t Rom::readByte(const Address& addr) {
 bool Rom::decodeAddress(const Address& in, Address& out) {
     uint32_t addr = in.getAbsolute() - mBase;
     out = Address((addr >> 16) & 0xFF, addr & 0xFFFF);
-    return addr < mRom.size();
+    return addr < mSize;
+}
+
+bool Rom::getAddressRange(uint32_t& first, uint32_t& size) {
+    first = mBase;
+    size = mSize;
+    return true;
+}
+
+uint8_t* Rom::getPagePointer(const Address& addr, bool write) {
+    // Stores are ignored, so they still go through storeByte, and the
+    // bus only reads through the pointer.
+    uint32_t offset = addr.getBank() * BANK_SIZE_BYTES + addr.getOffset();
+    if (write || offset + PAGE_SIZE_BYTES > mSize) return 0;
+    return const_cast<uint8_t *>(mRom + offset);
+}
+
+void Rom::addMetrics(MetricsGroup &group) {
+    group.setKind("rom");
 }
@@ -0,0 +1,135 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "RomImage.hpp"
+#include "IntelHex.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Largest image that fits the 24-bit address space.
+#define MAX_IMAGE_SIZE 0x1000000
+
+namespace {
+
+// Images still in use, by file name.
+std::map<std::string, std::weak_ptr<const RomImage>> gOpenImages;
+std::mutex gOpenImagesMutex;
+
+} // namespace
+
+std::shared_ptr<const RomImage> RomImage::open(const std::string &filename, std::string &error) {
+    std::lock_guard<std::mutex> lock(gOpenImagesMutex);
+    std::shared_ptr<const RomImage> image = gOpenImages[filename].lock();
+    if (image) return image;
+
+    std::shared_ptr<RomImage> created(new RomImage());
+    const bool loaded = IntelHex::isHexFile(filename) ? created->decodeHex(filename, error) : created->map(filename, error);
+    if (!loaded) return nullptr;
+    if (created->mSize == 0) {
+        error = filename + " is empty";
+        return nullptr;
+    }
+    gOpenImages[filename] = created;
+    return created;
+}
+
+RomImage::~RomImage() {
+    if (!mView) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(mView);
+#else
+    munmap(mView, mViewSize);
+#endif
+}
+
+bool RomImage::map(const std::string &filename, std::string &error) {
+    error = "cannot read " + filename;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart > MAX_IMAGE_SIZE) {
+        CloseHandle(file);
+        error = filename + " is larger than the address space";
+        return false;
+    }
+    mViewSize = (size_t)size.QuadPart;
+    if (mViewSize > 0) {
+        // The view keeps the mapping open after the handles are closed.
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            mView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        return false;
+    }
+    if (status.st_size > MAX_IMAGE_SIZE) {
+        close(fd);
+        error = filename + " is larger than the address space";
+        return false;
+    }
+    mViewSize = (size_t)status.st_size;
+    if (mViewSize > 0) {
+        void *view = mmap(0, mViewSize, PROT_READ, MAP_SHARED, fd, 0);
+        if (view != MAP_FAILED) mView = view;
+    }
+    close(fd);
+#endif
+    if (mViewSize > 0 && !mView) return false;
+    mData = (const uint8_t *)mView;
+    mSize = (uint32_t)mViewSize;
+    error.clear();
+    return true;
+}
+
+bool RomImage::decodeHex(const std::string &filename, std::string &error) {
+    IntelHex hex;
+    if (!hex.read(filename, error)) return false;
+    for (const IntelHex::Run &run : hex.runs()) {
+        if (mDecoded.size() < run.address + run.bytes.size()) mDecoded.resize(run.address + run.bytes.size(), 0);
+        std::copy(run.bytes.begin(), run.bytes.end(), mDecoded.begin() + run.address);
+    }
+    mData = mDecoded.data();
+    mSize = (uint32_t)mDecoded.size();
+    return true;
+}
@@ -0,0 +1,198 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Sampler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+// Stack pointer recorded for the root frame, which no return pops.
+#define ROOT_STACK_POINTER 0x10000
+
+// Shadow stack frames kept before the oldest are dropped.
+#define MAX_FRAMES 1024
+
+// First bytes of a saved buffer, followed by little-endian words: for
+// each distinct sample its words, then its count as two words, low first.
+#define FILE_MAGIC "DT65SMP2"
+#define FILE_MAGIC_LENGTH 8
+
+// Earlier buffers with every sample written out once, and no counts.
+#define FILE_MAGIC_UNCOUNTED "DT65SMP1"
+
+namespace {
+
+struct Line {
+    std::string name;
+    uint64_t count;
+};
+
+void writeSection(std::ostream &out, const char *title, const std::map<std::string, uint64_t> &counts,
+                  uint64_t total, size_t limit) {
+    std::vector<Line> lines;
+    for (const auto &entry : counts) lines.push_back(Line { entry.first, entry.second });
+    std::sort(lines.begin(), lines.end(),
+        [](const Line &a, const Line &b) { return a.count > b.count; });
+
+    out << title << std::endl;
+    out << std::setw(10) << "samples" << std::setw(8) << "%" << "  location" << std::endl;
+    for (size_t i = 0; i < lines.size() && i < limit; ++i) {
+        out << std::setw(10) << lines[i].count
+            << std::setw(8) << std::fixed << std::setprecision(2) << (total ? 100.0 * lines[i].count / total : 0.0)
+            << "  " << lines[i].name << std::endl;
+    }
+    out << std::endl;
+}
+
+} // namespace
+
+Sampler::Sampler(uint32_t interval, uint32_t seed) :
+        mInterval(interval ? interval : 1),
+        mRandom(seed ? seed : 1),
+        mCount(0) {
+}
+
+uint64_t Sampler::start(uint32_t addr, uint64_t cycles) {
+    mFrames.clear();
+    mFrames.push_back(Frame { addr, ROOT_STACK_POINTER });
+    return nextDeadline(cycles);
+}
+
+void Sampler::enter(uint32_t addr, uint16_t stackPointer) {
+    while (mFrames.size() > 1 && mFrames.back().stackPointer <= stackPointer) {
+        mFrames.pop_back();
+    }
+    if (mFrames.size() == MAX_FRAMES) mFrames.erase(mFrames.begin() + 1);
+    mFrames.push_back(Frame { addr, stackPointer });
+}
+
+void Sampler::leave(uint16_t stackPointer) {
+    while (mFrames.size() > 1 && mFrames.back().stackPointer < stackPointer) {
+        mFrames.pop_back();
+    }
+}
+
+uint64_t Sampler::sample(uint32_t pc, uint64_t cycles) {
+    const uint32_t depth = std::min<size_t>(mFrames.size(), SAMPLE_STACK_DEPTH);
+    Stack stack = {};
+    stack[0] = (depth << 24) | (pc & 0xFFFFFF);
+    for (uint32_t i = 0; i < depth; ++i) {
+        stack[1 + i] = mFrames[mFrames.size() - 1 - i].address;
+    }
+    ++mSamples[stack];
+    ++mCount;
+    return nextDeadline(cycles);
+}
+
+uint64_t Sampler::nextDeadline(uint64_t cycles) {
+    // xorshift32; the next sample falls uniformly within half an interval
+    // either side of the mean.
+    mRandom ^= mRandom << 13;
+    mRandom ^= mRandom >> 17;
+    mRandom ^= mRandom << 5;
+    return cycles + mInterval / 2 + mRandom % mInterval + 1;
+}
+
+bool Sampler::load(const std::string &filename) {
+    std::ifstream infile(filename, std::ios_base::binary);
+    if (!infile) return false;
+
+    char magic[FILE_MAGIC_LENGTH];
+    if (!infile.read(magic, FILE_MAGIC_LENGTH)) return false;
+    const std::string kind(magic, FILE_MAGIC_LENGTH);
+    const bool counted = kind == FILE_MAGIC;
+    if (!counted && kind != FILE_MAGIC_UNCOUNTED) return false;
+
+    std::vector<uint32_t> words;
+    unsigned char bytes[4];
+    while (infile.read((char *)bytes, sizeof(bytes))) {
+        words.push_back(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+    }
+
+    // Check the sample structure before taking any of it.
+    std::map<Stack, uint64_t> samples;
+    uint64_t total = 0;
+    size_t i = 0;
+    while (i < words.size()) {
+        const uint32_t depth = words[i] >> 24;
+        const size_t size = 1 + depth + (counted ? 2 : 0);
+        if (depth > SAMPLE_STACK_DEPTH || words.size() - i < size) return false;
+        Stack stack = {};
+        std::copy(words.begin() + i, words.begin() + i + 1 + depth, stack.begin());
+        const uint64_t count = counted ? words[i + 1 + depth] | ((uint64_t)words[i + 2 + depth] << 32) : 1;
+        samples[stack] += count;
+        total += count;
+        i += size;
+    }
+
+    for (const auto &entry : samples) mSamples[entry.first] += entry.second;
+    mCount += total;
+    return true;
+}
+
+bool Sampler::save(const std::string &filename) const {
+    std::ofstream outfile(filename, std::ios_base::binary);
+    if (!outfile) return false;
+
+    outfile.write(FILE_MAGIC, FILE_MAGIC_LENGTH);
+    for (const auto &entry : mSamples) {
+        const Stack &stack = entry.first;
+        std::vector<uint32_t> words(stack.begin(), stack.begin() + 1 + (stack[0] >> 24));
+        words.push_back((uint32_t)entry.second);
+        words.push_back((uint32_t)(entry.second >> 32));
+        for (uint32_t word : words) {
+            const unsigned char bytes[4] = {
+                (unsigned char)word, (unsigned char)(word >> 8), (unsigned char)(word >> 16), (unsigned char)(word >> 24)
+            };
+            outfile.write((const char *)bytes, sizeof(bytes));
+        }
+    }
+    return (bool)outfile;
+}
+
+void Sampler::report(std::ostream &out, const Symbols &symbols, size_t limit) const {
+    std::map<std::string, uint64_t> routines;
+    std::map<std::string, uint64_t> addresses;
+    for (const auto &entry : mSamples) {
+        const uint32_t pc = entry.first[0] & 0xFFFFFF;
+        routines[symbols.routine(pc)] += entry.second;
+        addresses[symbols.describe(pc)] += entry.second;
+    }
+
+    out << "Total: " << mCount << " samples" << std::endl << std::endl;
+    writeSection(out, "Samples by routine:", routines, mCount, limit);
+    writeSection(out, "Samples by address:", addresses, mCount, limit);
+}
+
+void Sampler::writeCollapsed(std::ostream &out, const Symbols &symbols) const {
+    std::map<std::string, uint64_t> stacks;
+    for (const auto &entry : mSamples) {
+        const Stack &stack = entry.first;
+        const uint32_t depth = stack[0] >> 24;
+        std::string path;
+        for (uint32_t level = depth; level > 0; --level) {
+            if (!path.empty()) path += ";";
+            path += symbols.describe(stack[level]);
+        }
+        if (path.empty()) path = symbols.routine(stack[0] & 0xFFFFFF);
+        stacks[path] += entry.second;
+    }
+    for (const auto &entry : stacks) {
+        out << entry.first << " " << entry.second << std::endl;
+    }
+}
@@ -22,22 +22,29 @@
 
 #define LOG_TAG "Stack"
 
+// Larger than any page number in bank zero.
+#define NO_PAGE 0x100
+
 Stack::Stack(SystemBus *systemBus) :
-        mSystemBus(systemBus) {
+        mSystemBus(systemBus),
+        mStackPointer(0),
+        mCachedPage(NO_PAGE),
+        mCachedGeneration(0),
+        mReadPage(nullptr),
+        mWritePage(nullptr) {
     setEmulation();
 }
 
 Stack::Stack(SystemBus *systemBus, uint16_t stackPointer) :
         mSystemBus(systemBus),
-        mStackAddress(0x00, stackPointer) {
+        mStackPointer(stackPointer),
+        mCachedPage(NO_PAGE),
+        mCachedGeneration(0),
+        mReadPage(nullptr),
+        mWritePage(nullptr) {
     Log::trc(LOG_TAG).str("Set to ").hex(stackPointer, 4).show();
 }
 
-void Stack::push8Bit(uint8_t value) {
-    mSystemBus->storeByte(mStackAddress, value);
-    mStackAddress.decrementOffsetBy(sizeof(uint8_t));
-}
-
 void Stack::push16Bit(uint16_t value) {
     auto leastSignificant = (uint8_t)((value) & 0xFF);
     auto mostSignificant =  (uint8_t)(((value) & 0xFF00) >> 8);
@@ -45,19 +52,21 @@ void Stack::push16Bit(uint16_t value) {
     push8Bit(leastSignificant);
 }
 
-uint8_t Stack::pull8Bit() {
-    mStackAddress.incrementOffsetBy(sizeof(uint8_t));
-    return mSystemBus->readByte(mStackAddress);
-}
-
 uint16_t Stack::pull16Bit() {
     return (uint16_t)(pull8Bit() | (((uint16_t)pull8Bit()) << 8));
 }
 
 uint16_t Stack::getStackPointer() {
-    return mStackAddress.getOffset();
+    return mStackPointer;
 }
 
 void Stack::setEmulation() {
-    mStackAddress = Address(0x00, 0x0100 | (mStackAddress.getOffset() & 0xFF));
+    mStackPointer = 0x0100 | (mStackPointer & 0xFF);
+}
+
+void Stack::cachePage() {
+    mCachedPage = mStackPointer >> 8;
+    mCachedGeneration = mSystemBus->generation();
+    mReadPage = mSystemBus->readPage(mStackPointer);
+    mWritePage = mSystemBus->writePage(mStackPointer);
 }
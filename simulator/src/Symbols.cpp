@@ -0,0 +1,205 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Symbols.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+bool endsWith(const std::string &s, const char *suffix) {
+    const std::string tail(suffix);
+    return s.size() >= tail.size() && s.compare(s.size() - tail.size(), tail.size(), tail) == 0;
+}
+
+bool isHex(const std::string &s) {
+    if (s.empty()) return false;
+    for (char c : s) {
+        if (!isxdigit((unsigned char)c)) return false;
+    }
+    return true;
+}
+
+bool isIdentifierStart(char c) {
+    return isalpha((unsigned char)c) || c == '_';
+}
+
+bool isIdentifierChar(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// Number of "::" scope separators in a name.
+size_t scopeDepth(const std::string &name) {
+    size_t depth = 0;
+    for (size_t pos = name.find("::"); pos != std::string::npos; pos = name.find("::", pos + 2)) {
+        ++depth;
+    }
+    return depth;
+}
+
+} // namespace
+
+bool Symbols::load(const std::string &filename) {
+    if (endsWith(filename, ".map")) return loadMap(filename);
+    if (endsWith(filename, ".lst")) return loadListing(filename);
+    return loadLabels(filename);
+}
+
+bool Symbols::loadLabels(const std::string &filename) {
+    std::ifstream infile(filename);
+    if (!infile) return false;
+
+    std::string line;
+    while (std::getline(infile, line)) {
+        std::istringstream words(line);
+        std::string command, value, name;
+        if (!(words >> command >> value >> name) || command != "al" || !isHex(value)) continue;
+        if (name[0] == '.') name.erase(0, 1);
+        append(strtoul(value.c_str(), 0, 16) & 0xFFFFFF, name);
+    }
+    sort();
+    return true;
+}
+
+bool Symbols::loadMap(const std::string &filename) {
+    std::ifstream infile(filename);
+    if (!infile) return false;
+
+    // Only the exports list sorted by name is read; it has entries of
+    // the form "name value flags", two to a line.
+    std::string line;
+    bool inExports = false;
+    while (std::getline(infile, line)) {
+        if (!inExports) {
+            inExports = line.compare(0, 21, "Exports list by name:") == 0;
+            continue;
+        }
+        if (line.compare(0, 5, "-----") == 0) continue;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) break;
+
+        std::istringstream words(line);
+        std::string name, value, flags;
+        while (words >> name >> value >> flags) {
+            if (isHex(value)) append(strtoul(value.c_str(), 0, 16) & 0xFFFFFF, name);
+        }
+    }
+    sort();
+    return true;
+}
+
+bool Symbols::loadListing(const std::string &filename) {
+    std::ifstream infile(filename);
+    if (!infile) return false;
+
+    // Listing lines start with the six-digit address, a relocation flag,
+    // the include depth and up to four bytes of code. Source text starts
+    // in column 24.
+    std::vector<std::string> scopes;
+    std::string line;
+    while (std::getline(infile, line)) {
+        if (line.size() <= 24 || !isHex(line.substr(0, 6))) continue;
+        const uint32_t address = strtoul(line.substr(0, 6).c_str(), 0, 16);
+
+        size_t pos = line.find_first_not_of(" \t", 24);
+        if (pos == std::string::npos) continue;
+
+        if (line.compare(pos, 5, ".proc") == 0 || line.compare(pos, 5, ".PROC") == 0) {
+            std::istringstream words(line.substr(pos + 5));
+            std::string name;
+            if (words >> name) {
+                append(address, scopes.empty() ? name : scopes.back() + "::" + name);
+                scopes.push_back(scopes.empty() ? name : scopes.back() + "::" + name);
+            }
+            continue;
+        }
+        if (line.compare(pos, 8, ".endproc") == 0 || line.compare(pos, 8, ".ENDPROC") == 0) {
+            if (!scopes.empty()) scopes.pop_back();
+            continue;
+        }
+
+        // A label is an identifier followed by a single colon.
+        if (!isIdentifierStart(line[pos])) continue;
+        size_t end = pos;
+        while (end < line.size() && isIdentifierChar(line[end])) ++end;
+        if (end >= line.size() || line[end] != ':' || (end + 1 < line.size() && line[end + 1] == ':')) continue;
+
+        const std::string name = line.substr(pos, end - pos);
+        append(address, scopes.empty() ? name : scopes.back() + "::" + name);
+    }
+    sort();
+    return true;
+}
+
+void Symbols::add(uint32_t addr, const std::string &name) {
+    append(addr, name);
+    sort();
+}
+
+const std::string *Symbols::lookup(uint32_t addr, uint32_t &offset) const {
+    auto it = std::upper_bound(mSymbols.begin(), mSymbols.end(), addr,
+        [](uint32_t a, const Symbol &symbol) { return a < symbol.address; });
+    if (it == mSymbols.begin()) return 0;
+    --it;
+    if ((it->address >> 16) != (addr >> 16)) return 0;
+
+    // Several names can share an address. Prefer the outermost one,
+    // which is a procedure rather than a label inside it.
+    auto best = it;
+    while (it != mSymbols.begin() && (it - 1)->address == best->address) {
+        --it;
+        if (scopeDepth(it->name) <= scopeDepth(best->name)) best = it;
+    }
+
+    offset = addr - best->address;
+    return &best->name;
+}
+
+std::string Symbols::describe(uint32_t addr) const {
+    std::ostringstream out;
+    uint32_t offset;
+    const std::string *name = lookup(addr, offset);
+    if (name) {
+        out << *name;
+        if (offset) out << "+$" << std::hex << std::uppercase << offset;
+    } else {
+        out << "$" << std::hex << std::uppercase;
+        out.width(6);
+        out.fill('0');
+        out << addr;
+    }
+    return out.str();
+}
+
+std::string Symbols::routine(uint32_t addr) const {
+    uint32_t offset;
+    const std::string *name = lookup(addr, offset);
+    if (!name) return describe(addr);
+    return name->substr(0, name->find("::"));
+}
+
+void Symbols::append(uint32_t addr, const std::string &name) {
+    mSymbols.push_back(Symbol { addr, name });
+}
+
+void Symbols::sort() {
+    std::stable_sort(mSymbols.begin(), mSymbols.end(),
+        [](const Symbol &a, const Symbol &b) { return a.address < b.address; });
+}
@@ -18,84 +18,292 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include "SystemBus.hpp"
 #include "Log.hpp"
 
 #define LOG_TAG "SystemBus"
 
+// Number of 256-byte pages in the 24-bit address space.
+#define PAGE_COUNT 0x10000
+
+SystemBus::SystemBus() : mReadPages(PAGE_COUNT, nullptr), mWritePages(PAGE_COUNT, nullptr) {
+}
+
 void SystemBus::registerDevice(SystemBusDevice *device) {
     mDevices.push_back(device);
+    mDeviceAccesses.resize(2 * mDevices.size());
+    mapPages();
 }
 
-void SystemBus::storeByte(const Address &address, uint8_t value) {
-    for (SystemBusDevice *device : mDevices) {
-        Address decodedAddress;
-        if (device->decodeAddress(address, decodedAddress)) {
-            device->storeByte(decodedAddress, value);
+void SystemBus::mapPages() {
+    ++mGeneration;
+    mReadPages.assign(PAGE_COUNT, nullptr);
+    mWritePages.assign(PAGE_COUNT, nullptr);
+
+    // Devices registered first take priority, so paint their pages last.
+    for (auto it = mDevices.rbegin(); it != mDevices.rend(); ++it) {
+        SystemBusDevice *device = *it;
+        uint32_t first;
+        uint32_t size;
+        if (!device->getAddressRange(first, size)) {
+            // Nothing is known about where this device sits, so no page
+            // can safely bypass it.
+            mReadPages.assign(PAGE_COUNT, nullptr);
+            mWritePages.assign(PAGE_COUNT, nullptr);
             return;
         }
+        if (size == 0) continue;
+
+        const uint32_t last = first + size - 1;
+        for (uint32_t page = first >> 8; page <= (last >> 8) && page < PAGE_COUNT; ++page) {
+            const uint32_t pageFirst = page << 8;
+            const uint32_t pageLast = pageFirst | 0xFF;
+            uint8_t *readPointer = nullptr;
+            uint8_t *writePointer = nullptr;
+            // Pages the device only partly covers are shared with whatever
+            // lies beneath it and must be decoded per access.
+            if (first <= pageFirst && last >= pageLast) {
+                Address decodedAddress;
+                if (device->decodeAddress(Address(page >> 8, (page & 0xFF) << 8), decodedAddress)) {
+                    readPointer = device->getPagePointer(decodedAddress, false);
+                    writePointer = device->getPagePointer(decodedAddress, true);
+                }
+            }
+            mReadPages[page] = readPointer;
+            mWritePages[page] = writePointer;
+        }
+    }
+
+    // Watched pages always take the slow path, and so do protected pages
+    // until their first write.
+    for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+        const uint8_t kinds = mWatchpoints.pageKinds(page);
+        if (kinds & WATCH_READ) mReadPages[page] = nullptr;
+        if (kinds & (WATCH_WRITE | WATCH_CHANGE)) mWritePages[page] = nullptr;
+        if (mPageObserver && !mPageWritten[page]) mWritePages[page] = nullptr;
     }
 }
 
-void SystemBus::storeTwoBytes(const Address &address, uint16_t value) {
+void SystemBus::storeBytes(uint32_t first, const uint8_t *data, uint32_t size) {
+    while (size) {
+        first &= 0xFFFFFF;
+        const uint32_t run = std::min(size, 0x100 - (first & 0xFF));
+        uint8_t *page = mWritePages[first >> 8];
+        if (page) {
+            memcpy(page + (first & 0xFF), data, run);
+        } else {
+            for (uint32_t i = 0; i < run; ++i) {
+                storeDeviceByte(Address((first >> 16) & 0xFF, (first + i) & 0xFFFF), data[i]);
+            }
+        }
+        first += run;
+        data += run;
+        size -= run;
+    }
+}
+
+void SystemBus::remapPages(uint32_t first, uint32_t size) {
+    if (size == 0) return;
+    const uint32_t last = first + size - 1;
+    for (uint32_t page = first >> 8; page <= (last >> 8) && page < PAGE_COUNT; ++page) {
+        // The page may now be backed by other memory, whose first write
+        // the observer has not seen.
+        if (mPageObserver) mPageWritten[page] = false;
+        mapPage(page);
+    }
+}
+
+void SystemBus::mapPage(uint32_t page) {
+    // The same rules as mapPages, for one page: the first device that
+    // decodes any of it decides.
+    ++mGeneration;
+    const uint32_t pageFirst = page << 8;
+    const uint32_t pageLast = pageFirst | 0xFF;
+    SystemBusDevice *owner = nullptr;
+    bool covered = false;
     for (SystemBusDevice *device : mDevices) {
-        Address decodedAddress;
-        if (device->decodeAddress(address, decodedAddress)) {
-            uint8_t leastSignificantByte = (uint8_t)(value & 0xFF);
-            uint8_t mostSignificantByte = (uint8_t)((value & 0xFF00) >> 8);
-            device->storeByte(decodedAddress, leastSignificantByte);
-            decodedAddress.incrementOffsetBy(1);
-            device->storeByte(decodedAddress, mostSignificantByte);
+        uint32_t first;
+        uint32_t size;
+        if (!device->getAddressRange(first, size)) {
+            mReadPages[page] = nullptr;
+            mWritePages[page] = nullptr;
             return;
         }
+        if (owner || size == 0) continue;
+        const uint32_t last = first + size - 1;
+        if (first <= pageLast && last >= pageFirst) {
+            owner = device;
+            covered = first <= pageFirst && last >= pageLast;
+        }
     }
+
+    uint8_t *readPointer = nullptr;
+    uint8_t *writePointer = nullptr;
+    Address decodedAddress;
+    if (covered && owner->decodeAddress(Address(page >> 8, (page & 0xFF) << 8), decodedAddress)) {
+        readPointer = owner->getPagePointer(decodedAddress, false);
+        writePointer = owner->getPagePointer(decodedAddress, true);
+    }
+    const uint8_t kinds = mWatchpoints.pageKinds(page);
+    if (mPageObserver && !mPageWritten[page]) writePointer = nullptr;
+    mReadPages[page] = (kinds & WATCH_READ) ? nullptr : readPointer;
+    mWritePages[page] = (kinds & (WATCH_WRITE | WATCH_CHANGE)) ? nullptr : writePointer;
 }
 
-uint8_t SystemBus::readByte(const Address &address) {
-    for (SystemBusDevice *device : mDevices) {
-        Address decodedAddress;
-        if (device->decodeAddress(address, decodedAddress)) {
-            return device->readByte(decodedAddress);
+void SystemBus::setPageObserver(PageObserver *observer) {
+    mPageObserver = observer;
+    if (observer) {
+        protectPages();
+    } else {
+        mPageWritten.clear();
+        mapPages();
+    }
+}
+
+void SystemBus::protectPages() {
+    if (!mPageObserver) return;
+    mPageWritten.assign(PAGE_COUNT, false);
+    ++mGeneration;
+    for (uint8_t *&page : mWritePages) page = nullptr;
+}
+
+int SystemBus::addWatchpoint(const Address &first, const Address &last, uint8_t kinds) {
+    int id = mWatchpoints.add(first.getAbsolute(), last.getAbsolute(), kinds);
+    mapPages();
+    return id;
+}
+
+bool SystemBus::removeWatchpoint(int id) {
+    if (!mWatchpoints.remove(id)) return false;
+    mapPages();
+    return true;
+}
+
+SystemBusDevice *SystemBus::findDevice(const Address &address, Address &decodedAddress, size_t *index) {
+    for (size_t i = 0; i < mDevices.size(); ++i) {
+        if (mDevices[i]->decodeAddress(address, decodedAddress)) {
+            if (index) *index = i;
+            return mDevices[i];
         }
     }
-    return 0;
+    return nullptr;
 }
 
-uint16_t SystemBus::readTwoBytes(const Address &address) {
-    for (SystemBusDevice *device : mDevices) {
-        Address decodedAddress;
-        if (device->decodeAddress(address, decodedAddress)) {
-            uint8_t leastSignificantByte = device->readByte(decodedAddress);
-            decodedAddress.incrementOffsetBy(sizeof(uint8_t));
-            uint8_t mostSignificantByte = device->readByte(decodedAddress);
-            uint16_t value = ((uint16_t)mostSignificantByte << 8) | leastSignificantByte;
-            return value;
+int SystemBus::peekByte(uint32_t absolute) {
+    absolute &= 0xFFFFFF;
+    const uint8_t *page = mReadPages[absolute >> 8];
+    if (page) {
+        return page[absolute & 0xFF];
+    }
+    Address decodedAddress;
+    SystemBusDevice *device = findDevice(Address((absolute >> 16) & 0xFF, absolute & 0xFFFF), decodedAddress);
+    return device ? peekByte(device, decodedAddress) : -1;
+}
+
+int SystemBus::peekByte(SystemBusDevice *device, const Address &decodedAddress) {
+    // Only plain memory can be read back without side effects.
+    uint8_t *page = device->getPagePointer(
+        Address(decodedAddress.getBank(), decodedAddress.getOffset() & 0xFF00), false);
+    return page ? page[decodedAddress.getOffset() & 0xFF] : -1;
+}
+
+void SystemBus::storeDeviceByte(const Address &address, uint8_t value) {
+    Address decodedAddress;
+    size_t index;
+    SystemBusDevice *device = findDevice(address, decodedAddress, &index);
+    const uint32_t absolute = address.getAbsolute();
+    const bool watched = mWatchpoints.pageKinds(absolute >> 8) & (WATCH_WRITE | WATCH_CHANGE);
+    int oldValue = -1;
+    if (watched && device) {
+        oldValue = peekByte(device, decodedAddress);
+    }
+    if (mPageObserver && device && !mPageWritten[absolute >> 8]) {
+        // Only memory is saved; device registers are the device's job.
+        uint8_t *memory = device->getPagePointer(
+            Address(decodedAddress.getBank(), decodedAddress.getOffset() & 0xFF00), true);
+        if (memory) {
+            mPageWritten[absolute >> 8] = true;
+            mPageObserver->beforeFirstWrite(absolute >> 8, memory);
+            mapPage(absolute >> 8);
         }
     }
-    return 0;
+    if (device) {
+        device->storeByte(decodedAddress, value);
+        ++mDeviceAccesses[2 * index + 1];
+    }
+    if (watched) {
+        mWatchpoints.checkWrite(absolute, oldValue, value);
+    }
+}
+
+uint8_t SystemBus::readDeviceByte(const Address &address) {
+    Address decodedAddress;
+    size_t index;
+    SystemBusDevice *device = findDevice(address, decodedAddress, &index);
+    uint8_t value = 0;
+    if (device) {
+        value = device->readByte(decodedAddress);
+        ++mDeviceAccesses[2 * index];
+    }
+    const uint32_t absolute = address.getAbsolute();
+    if (mWatchpoints.pageKinds(absolute >> 8) & WATCH_READ) {
+        mWatchpoints.checkRead(absolute, value);
+    }
+    return value;
+}
+
+void SystemBus::storeTwoBytes(const Address &address, uint16_t value) {
+    const uint32_t absolute = address.getAbsolute();
+    uint8_t *page = mWritePages[absolute >> 8];
+    if (page && (absolute & 0xFF) != 0xFF) {
+        page[absolute & 0xFF] = (uint8_t)(value & 0xFF);
+        page[(absolute & 0xFF) + 1] = (uint8_t)(value >> 8);
+        return;
+    }
+    // Crossing into another page, or a page that needs the device.
+    storeDeviceByte(address, (uint8_t)(value & 0xFF));
+    storeDeviceByte(Address::sumOffsetToAddressWrapAround(address, 1), (uint8_t)((value & 0xFF00) >> 8));
+}
+
+uint16_t SystemBus::readTwoBytes(const Address &address) {
+    const uint32_t absolute = address.getAbsolute();
+    const uint8_t *page = mReadPages[absolute >> 8];
+    if (page && (absolute & 0xFF) != 0xFF) {
+        return page[absolute & 0xFF] | ((uint16_t)page[(absolute & 0xFF) + 1] << 8);
+    }
+    uint8_t leastSignificantByte = readByte(address);
+    uint8_t mostSignificantByte = readByte(Address::sumOffsetToAddressWrapAround(address, 1));
+    return ((uint16_t)mostSignificantByte << 8) | leastSignificantByte;
 }
 
 Address SystemBus::readAddressAt(const Address &address) {
-    Address decodedAddress { 0x00, 0x0000 };
-    for (SystemBusDevice *device : mDevices) {
-        if (device->decodeAddress(address, decodedAddress)) {
-            // Read offset
-            uint8_t leastSignificantByte = device->readByte(decodedAddress);
-            decodedAddress.incrementOffsetBy(sizeof(uint8_t));
-            uint8_t mostSignificantByte = device->readByte(decodedAddress);
-            uint16_t offset = ((uint16_t)mostSignificantByte << 8) | leastSignificantByte;
-            // Read bank
-            decodedAddress.incrementOffsetBy(sizeof(uint8_t));
-            uint8_t bank = device->readByte(decodedAddress);
-            return Address(bank, offset);
-        }
+    const uint32_t absolute = address.getAbsolute();
+    const uint8_t *page = mReadPages[absolute >> 8];
+    if (page && (absolute & 0xFF) < 0xFE) {
+        const uint8_t *bytes = page + (absolute & 0xFF);
+        return Address(bytes[2], bytes[0] | ((uint16_t)bytes[1] << 8));
     }
-    return decodedAddress;
+    uint16_t offset = readTwoBytes(address);
+    uint8_t bank = readByte(Address::sumOffsetToAddressWrapAround(address, 2));
+    return Address(bank, offset);
 }
 
-void SystemBus::addCycles(int cycles) {
+int SystemBus::addCycles(int cycles) {
     for (SystemBusDevice* device : mDevices) {
         device->addCycles(cycles);
     }
+    // Time passes for the devices while the CPU is stalled, too.
+    int elapsed = cycles;
+    while (mStallCycles) {
+        const int stalled = mStallCycles;
+        mStallCycles = 0;
+        for (SystemBusDevice* device : mDevices) {
+            device->addCycles(stalled);
+        }
+        elapsed += stalled;
+    }
+    return elapsed;
 }
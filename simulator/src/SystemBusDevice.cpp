@@ -17,7 +17,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cctype>
 #include <cmath>
+#include <cstdlib>
 
 #include "SystemBusDevice.hpp"
 
@@ -69,3 +71,26 @@ void Address::decrementOffsetBy(uint16_t offset) {
 void Address::incrementOffsetBy(uint16_t offset) {
     mOffset += offset;
 }
+
+bool Address::parse(const char *text, Address &out) {
+    if (text[0] == '$') {
+        ++text;
+    } else if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text += 2;
+    }
+    if (!isxdigit((unsigned char)text[0])) return false;
+
+    char *end;
+    unsigned long value = strtoul(text, &end, 16);
+    if (*end == ':') {
+        const char *offsetText = end + 1;
+        if (value > 0xFF || !isxdigit((unsigned char)offsetText[0])) return false;
+        unsigned long offset = strtoul(offsetText, &end, 16);
+        if (*end != '\0' || offset > 0xFFFF) return false;
+        out = Address((uint8_t)value, (uint16_t)offset);
+        return true;
+    }
+    if (*end != '\0' || value > 0xFFFFFF) return false;
+    out = Address((uint8_t)(value >> 16), (uint16_t)value);
+    return true;
+}
@@ -16,6 +16,7 @@
 // along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Uart.hpp"
+#include "DeviceState.hpp"
 #include "Log.hpp"
 
 #define LOG_TAG "Uart"
@@ -62,6 +63,12 @@
 #define RI 0x40
 #define DCD 0x80
 
+// Counters kept for metrics.
+#define COUNT_BYTES_IN 0
+#define COUNT_BYTES_OUT 1
+#define COUNT_OVERRUNS 2
+#define COUNT_SIZE 3
+
 UartPC16550D::UartPC16550D(const Address &baseAddr, Terminal *term) : mBase(baseAddr.getAbsolute()),
                                                                       mIER(0),
                                                                       mIIR(1),
@@ -71,8 +78,12 @@ UartPC16550D::UartPC16550D(const Address &baseAddr, Terminal *term) : mBase(base
                                                                       mLSR(0x60),
                                                                       mMSR(0),
                                                                       mClocksPerByte(0xFFFFFFFF),
+                                                                      mClocksUntilSend(0),
+                                                                      mCycles(0),
                                                                       rbrFull(false),
-                                                                      mTerm(term)
+                                                                      mTerm(term),
+                                                                      mInput(0),
+                                                                      mCounts(COUNT_SIZE)
 {
 }
 
@@ -290,8 +301,16 @@ bool UartPC16550D::decodeAddress(const Address &in, Address &out)
     return addr < 8; // 3 address lines
 }
 
+bool UartPC16550D::getAddressRange(uint32_t &first, uint32_t &size)
+{
+    first = mBase;
+    size = 8;
+    return true;
+}
+
 void UartPC16550D::addCycles(int cycles)
 {
+    mCycles += cycles;
     mClocksUntilSend -= cycles;
     if (mClocksUntilSend > 0)
         return;
@@ -318,6 +337,7 @@ void UartPC16550D::addCycles(int cycles)
             mLSR |= THRE | TEMT;
         }
         Log::trc(LOG_TAG).str("Transmitting ").hex(val, 2).show();
+        ++mCounts[COUNT_BYTES_OUT];
 
         if (mTerm)
         {
@@ -326,12 +346,26 @@ void UartPC16550D::addCycles(int cycles)
         }
     }
 
-    // Check for something to read
-    if (mTerm)
+    // Check for something to read. A replayed byte arrives at the same
+    // cycle it was recorded at, since this is only reached on the same
+    // byte-time boundaries.
+    if (mInput && mInput->replaying())
+    {
+        int val = mInput->take(mBase, mCycles);
+        if (val >= 0)
+        {
+            receive((uint8_t)val);
+        }
+    }
+    else if (mTerm)
     {
         uint8_t val = mTerm->read();
         if (val)
         {
+            if (mInput)
+            {
+                mInput->put(mBase, mCycles, val);
+            }
             receive(val);
         }
     }
@@ -339,6 +373,70 @@ void UartPC16550D::addCycles(int cycles)
     checkForInterrupts();
 }
 
+void UartPC16550D::saveState(DeviceState &state)
+{
+    state.put(mRBR);
+    state.put(mTHR);
+    state.put(mIER);
+    state.put(mIIR);
+    state.put(mFCR);
+    state.put(mLCR);
+    state.put(mMCR);
+    state.put(mLSR);
+    state.put(mMSR);
+    state.put(mSCR);
+    state.put(mDLL);
+    state.put(mDLM);
+    state.put(mClocksPerByte);
+    state.put(mClocksUntilSend);
+    state.put(mCycles);
+    state.put(mInput ? mInput->position(mBase) : (size_t)0);
+    state.put(rbrFull);
+    state.put(mRcvrFifo.size());
+    for (uint8_t val : mRcvrFifo)
+        state.put(val);
+    state.put(mXmitFifo.size());
+    for (uint8_t val : mXmitFifo)
+        state.put(val);
+}
+
+void UartPC16550D::restoreState(DeviceState &state)
+{
+    mRBR = state.get<uint8_t>();
+    mTHR = state.get<uint8_t>();
+    mIER = state.get<uint8_t>();
+    mIIR = state.get<uint8_t>();
+    mFCR = state.get<uint8_t>();
+    mLCR = state.get<uint8_t>();
+    mMCR = state.get<uint8_t>();
+    mLSR = state.get<uint8_t>();
+    mMSR = state.get<uint8_t>();
+    mSCR = state.get<uint8_t>();
+    mDLL = state.get<uint8_t>();
+    mDLM = state.get<uint8_t>();
+    mClocksPerByte = state.get<uint32_t>();
+    mClocksUntilSend = state.get<int>();
+    mCycles = state.get<uint64_t>();
+    const size_t replayed = state.get<size_t>();
+    if (mInput)
+        mInput->seek(mBase, replayed);
+    rbrFull = state.get<bool>();
+    mRcvrFifo.resize(state.get<size_t>());
+    for (uint8_t &val : mRcvrFifo)
+        val = state.get<uint8_t>();
+    mXmitFifo.resize(state.get<size_t>());
+    for (uint8_t &val : mXmitFifo)
+        val = state.get<uint8_t>();
+}
+
+void UartPC16550D::addMetrics(MetricsGroup &group)
+{
+    group.setKind("uart");
+    group.add("bytes_in", mCounts[COUNT_BYTES_IN]);
+    group.add("bytes_out", mCounts[COUNT_BYTES_OUT]);
+    group.add("overruns", mCounts[COUNT_OVERRUNS]);
+}
+
 void UartPC16550D::checkForInterrupts()
 {
     if (!mIER)
@@ -385,6 +483,7 @@ void UartPC16550D::send()
 
 void UartPC16550D::receive(uint8_t val)
 {
+    ++mCounts[COUNT_BYTES_IN];
     if (mFCR & FIFO_ENABLE)
     {
         mRcvrFifo.push_back(val);
@@ -393,6 +492,7 @@ void UartPC16550D::receive(uint8_t val)
         {
             mLSR |= OE;
             mRcvrFifo.pop_back();
+            ++mCounts[COUNT_OVERRUNS];
         }
     }
     else
@@ -401,6 +501,7 @@ void UartPC16550D::receive(uint8_t val)
         {
             // Set RBR not read before filled error
             mLSR |= OE;
+            ++mCounts[COUNT_OVERRUNS];
         }
         mRBR = val;
         mLSR |= DR;
@@ -0,0 +1,83 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+#include "Watchpoints.hpp"
+
+Watchpoints::Watchpoints() : mPageKinds(0x10000, 0), mNextId(1) {
+}
+
+int Watchpoints::add(uint32_t first, uint32_t last, uint8_t kinds) {
+    first &= 0xFFFFFF;
+    last &= 0xFFFFFF;
+    if (last < first) last = first;
+
+    const int id = mNextId++;
+    mWatches[id] = Watch { first, last, kinds };
+    updatePages(first, last);
+    return id;
+}
+
+bool Watchpoints::remove(int id) {
+    auto it = mWatches.find(id);
+    if (it == mWatches.end()) return false;
+    const Watch watch = it->second;
+    mWatches.erase(it);
+    updatePages(watch.first, watch.last);
+    return true;
+}
+
+void Watchpoints::checkRead(uint32_t addr, uint8_t value) {
+    for (const auto &entry : mWatches) {
+        const Watch &watch = entry.second;
+        if ((watch.kinds & WATCH_READ) && addr >= watch.first && addr <= watch.last) {
+            mHits.push_back(Hit { addr, WATCH_READ, -1, value });
+            return;
+        }
+    }
+}
+
+void Watchpoints::checkWrite(uint32_t addr, int oldValue, uint8_t newValue) {
+    // Without a readable old value every store counts as a change.
+    const bool changed = oldValue != newValue;
+    for (const auto &entry : mWatches) {
+        const Watch &watch = entry.second;
+        if (addr < watch.first || addr > watch.last) continue;
+        if (watch.kinds & WATCH_WRITE) {
+            mHits.push_back(Hit { addr, WATCH_WRITE, oldValue, newValue });
+            return;
+        }
+        if ((watch.kinds & WATCH_CHANGE) && changed) {
+            mHits.push_back(Hit { addr, WATCH_CHANGE, oldValue, newValue });
+            return;
+        }
+    }
+}
+
+void Watchpoints::updatePages(uint32_t first, uint32_t last) {
+    for (uint32_t page = first >> 8; page <= (last >> 8); ++page) {
+        const uint32_t pageFirst = page << 8;
+        const uint32_t pageLast = pageFirst | 0xFF;
+        uint8_t kinds = 0;
+        for (const auto &entry : mWatches) {
+            const Watch &watch = entry.second;
+            if (watch.first <= pageLast && watch.last >= pageFirst) {
+                kinds |= watch.kinds;
+            }
+        }
+        mPageKinds[page] = kinds;
+    }
+}
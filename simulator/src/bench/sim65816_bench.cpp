@@ -0,0 +1,513 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+
+// Micro-benchmarks for the simulator core, reported as JSON.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Binary.hpp"
+#include "Cpu65816.hpp"
+#include "Cpu65816Debugger.hpp"
+#include "Disassembler.hpp"
+#include "HostServices.hpp"
+#include "Log.hpp"
+#include "Machine.hpp"
+#include "Ram.hpp"
+#include "Rom.hpp"
+#include "SystemBus.hpp"
+#include "Uart.hpp"
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Temporary ROM image written for the ROM benchmarks.
+#define ROM_IMAGE "sim65816_bench.rom"
+
+// Where each opcode benchmark places its instruction.
+#define BENCH_PC 0x8000
+
+// Stack pointer restored between opcode benchmark batches.
+#define BENCH_SP 0x7FFF
+
+// Opcode executions between stack pointer resets.
+#define STACK_RESET_INTERVAL 256
+
+// Guest programs are loaded and started here.
+#define GUEST_BASE 0x1000
+
+// RAM banks given to guest programs.
+#define GUEST_RAM_BANKS 4
+
+// Cycles after which a guest program that has not reached STP is stopped.
+#define GUEST_CYCLE_LIMIT 10000000000ULL
+
+namespace {
+
+struct Options {
+    const char *filter = 0;
+    const char *output = 0;
+    int repetitions = 3;
+    double scale = 1.0;
+    std::vector<const char *> guests;
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double bestNs;
+    double meanNs;
+};
+
+struct GuestResult {
+    std::string name;
+    const char *mode;
+    bool stopped;
+    uint64_t cycles;
+    double seconds;
+    uint16_t a;
+};
+
+// Ways of running the core, from the bare interpreter loop to the
+// debugger, with handlers or with an empty hook policy, and each analysis
+// hook, and last with WDM host services.
+const char *const GUEST_MODES[] = {
+    "interpreter", "debugger", "nohooks", "profiler", "callgraph", "coverage", "sampler", "services"
+};
+
+Options gOptions;
+std::vector<Result> gResults;
+std::vector<GuestResult> gGuestResults;
+
+// Keeps values computed by a benchmark alive.
+volatile uint32_t gSink;
+
+/// @brief Time a benchmark.
+/// @details
+/// The body is called with an iteration count and must do that many
+/// operations. One untimed call warms caches, then the best and mean time
+/// per operation over the repetitions are recorded.
+template <typename Body>
+void bench(const std::string &name, uint64_t iterations, Body body) {
+    if (gOptions.filter && name.find(gOptions.filter) == std::string::npos) return;
+    iterations = std::max<uint64_t>(1, (uint64_t)(iterations * gOptions.scale));
+
+    body(std::min<uint64_t>(iterations, 1000));
+    double best = 0;
+    double total = 0;
+    for (int rep = 0; rep < gOptions.repetitions; ++rep) {
+        const auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        const auto stop = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+        best = rep == 0 ? ns : std::min(best, ns);
+        total += ns;
+    }
+    gResults.push_back(Result { name, iterations, best, total / gOptions.repetitions });
+    std::cerr << name << ": " << best << " ns" << std::endl;
+}
+
+std::string hex2(uint8_t value) {
+    char text[3];
+    snprintf(text, sizeof(text), "%02X", value);
+    return text;
+}
+
+void writeJson(std::ostream &out) {
+    out << "{" << std::endl
+        << "  \"benchmarks\": [" << std::endl;
+    for (size_t i = 0; i < gResults.size(); ++i) {
+        const Result &result = gResults[i];
+        out << "    {\"name\": \"" << result.name << "\""
+            << ", \"iterations\": " << result.iterations
+            << ", \"ns_per_op\": " << result.bestNs
+            << ", \"mean_ns_per_op\": " << result.meanNs
+            << ", \"mops\": " << (result.bestNs > 0 ? 1000.0 / result.bestNs : 0.0)
+            << "}" << (i + 1 < gResults.size() ? "," : "") << std::endl;
+    }
+    out << "  ]," << std::endl
+        << "  \"guests\": [" << std::endl;
+    for (size_t i = 0; i < gGuestResults.size(); ++i) {
+        const GuestResult &result = gGuestResults[i];
+        out << "    {\"name\": \"" << result.name << "\""
+            << ", \"mode\": \"" << result.mode << "\""
+            << ", \"stopped\": " << (result.stopped ? "true" : "false")
+            << ", \"cycles\": " << result.cycles
+            << ", \"seconds\": " << result.seconds
+            << ", \"mhz\": " << (result.seconds > 0 ? result.cycles / result.seconds / 1e6 : 0.0)
+            << ", \"a\": " << result.a
+            << "}" << (i + 1 < gGuestResults.size() ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl
+        << "}" << std::endl;
+}
+
+/// @brief Run a guest program once from RAM until it executes STP.
+/// @param image program loaded at GUEST_BASE
+/// @param mode one of GUEST_MODES
+GuestResult runGuestOnce(const std::vector<uint8_t> &image, const char *mode) {
+    Machine machine;
+    machine.addRam(GUEST_RAM_BANKS);
+    for (size_t i = 0; i < image.size(); ++i) {
+        const uint32_t address = GUEST_BASE + i;
+        machine.bus().storeByte(Address((address >> 16) & 0xFF, address & 0xFFFF), image[i]);
+    }
+
+    Cpu65816 &cpu = machine.cpu();
+    Profiler profiler;
+    CallGraph callGraph;
+    Coverage coverage;
+    Sampler sampler;
+    HostServices services;
+    GuestResult result { "", mode, false, 0, 0.0, 0 };
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!strcmp(mode, "debugger")) {
+        Cpu65816Debugger debugger(cpu);
+        cpu.setProgramAddress(Address(0x00, GUEST_BASE));
+        bool stopped = false;
+        debugger.doBeforeStep([]() {});
+        debugger.doAfterStep([]() {});
+        debugger.onBreakPoint([]() {});
+        debugger.onStp([&stopped]() { stopped = true; });
+        while (!stopped && cpu.getTotalCycles() < GUEST_CYCLE_LIMIT) {
+            debugger.step();
+        }
+        result.stopped = stopped;
+    } else if (!strcmp(mode, "nohooks")) {
+        Cpu65816Debugger debugger(cpu);
+        cpu.setProgramAddress(Address(0x00, GUEST_BASE));
+        NoHooks hooks;
+        result.stopped = debugger.runUntil(hooks, GUEST_CYCLE_LIMIT) == StopReason::Stp;
+    } else {
+        machine.reset();
+        cpu.setProgramAddress(Address(0x00, GUEST_BASE));
+        if (!strcmp(mode, "profiler")) cpu.setProfiler(&profiler);
+        if (!strcmp(mode, "callgraph")) cpu.setCallGraph(&callGraph);
+        if (!strcmp(mode, "coverage")) cpu.setCoverage(&coverage);
+        if (!strcmp(mode, "sampler")) cpu.setSampler(&sampler);
+        if (!strcmp(mode, "services")) cpu.setHostServices(&services);
+        result.stopped = machine.run(GUEST_CYCLE_LIMIT, 0) == StopReason::Stp;
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    result.cycles = cpu.getTotalCycles();
+    result.seconds = std::chrono::duration<double>(stop - start).count();
+    result.a = cpu.getA();
+    return result;
+}
+
+/// @brief Run a guest program in every mode, keeping the fastest run.
+/// @return false if the program could not be read
+bool runGuest(const char *filename) {
+    std::ifstream infile(filename, std::ios_base::binary);
+    if (!infile) return false;
+    std::vector<uint8_t> image((std::istreambuf_iterator<char>(infile)),
+                               std::istreambuf_iterator<char>());
+
+    std::string name(filename);
+    const size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) name.erase(0, slash + 1);
+    const size_t dot = name.rfind('.');
+    if (dot != std::string::npos) name.resize(dot);
+
+    for (const char *mode : GUEST_MODES) {
+        if (gOptions.filter && (name + "/" + mode).find(gOptions.filter) == std::string::npos) continue;
+        GuestResult best = runGuestOnce(image, mode);
+        for (int rep = 1; rep < gOptions.repetitions; ++rep) {
+            const GuestResult result = runGuestOnce(image, mode);
+            if (result.seconds < best.seconds) best = result;
+        }
+        best.name = name;
+        gGuestResults.push_back(best);
+        std::cerr << name << "/" << mode << ": " << best.cycles << " cycles, " << best.seconds << " s, "
+                  << (best.seconds > 0 ? best.cycles / best.seconds / 1e6 : 0.0) << " MHz"
+                  << (best.stopped ? "" : " (no STP)") << std::endl;
+    }
+    return true;
+}
+
+} // namespace
+
+/// @brief Drives CPU internals for the benchmarks.
+class Cpu65816Bench {
+public:
+    Cpu65816Bench(Cpu65816 &cpu, SystemBus &bus) : mCpu(cpu), mBus(bus) {
+    }
+
+    /// @brief Run one opcode repeatedly in a register width mode.
+    void opcodes(bool m8, bool x8) {
+        const std::string mode = std::string(m8 ? "m8" : "m16") + (x8 ? "x8" : "x16");
+        for (int code = 0; code < 256; ++code) {
+            OpCode opCode = Cpu65816::OP_CODE_TABLE[code];
+            const OpCodeInfo &info = Disassembler::OP_CODE_INFO[code];
+
+            // Operands point at low RAM: direct page $01, absolute $0001,
+            // long $00:0001, block move banks $01 and $00.
+            const Address pc(0x00, BENCH_PC);
+            mBus.storeByte(pc, (uint8_t)code);
+            mBus.storeByte(Address(0x00, BENCH_PC + 1), 0x01);
+            mBus.storeByte(Address(0x00, BENCH_PC + 2), 0x00);
+            mBus.storeByte(Address(0x00, BENCH_PC + 3), 0x00);
+
+            resetState(m8, x8);
+            mCpu.mOperand.resolved = false;
+            if (!opCode.execute(mCpu)) continue;
+
+            const std::string name = std::string("opcode/") + info.mnemonic + "_" + hex2((uint8_t)code) + "/" + mode;
+            bench(name, 20000, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    if ((i % STACK_RESET_INTERVAL) == 0) mCpu.mStack.setStackPointer(BENCH_SP);
+                    restoreRegisters(m8, x8);
+                    mCpu.executeNextInstruction();
+                }
+            });
+        }
+    }
+
+    /// @brief Decode the operand address of one opcode per addressing mode.
+    void decode() {
+        std::vector<bool> seen(256, false);
+        for (int code = 0; code < 256; ++code) {
+            OpCode opCode = Cpu65816::OP_CODE_TABLE[code];
+            const int mode = (int)opCode.getAddressingMode();
+            if (seen[mode]) continue;
+            seen[mode] = true;
+
+            resetState(true, true);
+            const std::string name = std::string("decode/") + Disassembler::OP_CODE_INFO[code].mnemonic + "_" + hex2((uint8_t)code);
+            bench(name, 1000000, [&](uint64_t n) {
+                uint32_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    mCpu.resolveOperand(opCode);
+                    sum += mCpu.mOperand.address.getAbsolute();
+                }
+                gSink = sum;
+            });
+        }
+    }
+
+    /// @brief Move 4 KiB blocks from bank 1 to bank 0 with MVN.
+    void blockMove() {
+        mBus.storeByte(Address(0x00, BENCH_PC), 0x54);
+        mBus.storeByte(Address(0x00, BENCH_PC + 1), 0x00);
+        mBus.storeByte(Address(0x00, BENCH_PC + 2), 0x01);
+        resetState(false, false);
+
+        // Timed per byte moved.
+        bench("mvn/4k", 4096 * 256, [&](uint64_t n) {
+            for (uint64_t moved = 0; moved < n; moved += 4096) {
+                restoreRegisters(false, false);
+                mCpu.mA = 4095;
+                mCpu.mX = 0x0000;
+                mCpu.mY = 0x1000;
+                mCpu.executeNextInstruction();
+            }
+        });
+    }
+
+private:
+    Cpu65816 &mCpu;
+    SystemBus &mBus;
+
+    void resetState(bool m8, bool x8) {
+        mCpu.mStack.setStackPointer(BENCH_SP);
+        restoreRegisters(m8, x8);
+    }
+
+    void restoreRegisters(bool m8, bool x8) {
+        mCpu.mPins.RES = false;
+        mCpu.mCpuStatus.setRegisterValue((m8 ? 0x20 : 0) | (x8 ? 0x10 : 0));
+        mCpu.mCpuStatus.clearEmulationFlag();
+        mCpu.mA = 0;
+        mCpu.mX = 0x0100;
+        mCpu.mY = 0x0200;
+        mCpu.mD = 0;
+        mCpu.mDB = 0;
+        mCpu.mProgramAddress = Address(0x00, BENCH_PC);
+    }
+};
+
+/// @brief Time the core's building blocks: bus access, devices, flags,
+/// operand decoding and every opcode.
+static void runMicroBenchmarks() {
+    {
+        std::ofstream image(ROM_IMAGE, std::ios_base::binary);
+        std::vector<char> bytes(0x4000);
+        for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = (char)i;
+        image.write(bytes.data(), bytes.size());
+    }
+    Rom rom(Address(0x00, 0xC000), ROM_IMAGE);
+    UartPC16550D uart(Address(0x00, 0xB000));
+    Ram ram(2);
+
+    SystemBus bus;
+    bus.registerDevice(&rom);
+    bus.registerDevice(&uart);
+    bus.registerDevice(&ram);
+
+    // System bus access per device type.
+    bench("bus/read/ram", 10000000, [&](uint64_t n) {
+        uint32_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) sum += bus.readByte(Address(0x01, (uint16_t)i));
+        gSink = sum;
+    });
+    bench("bus/write/ram", 10000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) bus.storeByte(Address(0x01, (uint16_t)i), (uint8_t)i);
+    });
+    bench("bus/read16/ram", 10000000, [&](uint64_t n) {
+        uint32_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) sum += bus.readTwoBytes(Address(0x01, (uint16_t)i));
+        gSink = sum;
+    });
+    bench("bus/read/rom", 10000000, [&](uint64_t n) {
+        uint32_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) sum += bus.readByte(Address(0x00, 0xC000 | (i & 0x3FFF)));
+        gSink = sum;
+    });
+    bench("bus/write/rom", 10000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) bus.storeByte(Address(0x00, 0xC000 | (i & 0x3FFF)), (uint8_t)i);
+    });
+    bench("bus/read/mmio", 1000000, [&](uint64_t n) {
+        uint32_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) sum += bus.readByte(Address(0x00, 0xB005));
+        gSink = sum;
+    });
+    bench("bus/write/mmio", 1000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) bus.storeByte(Address(0x00, 0xB007), (uint8_t)i);
+    });
+
+    // UART registers without the bus.
+    bench("uart/read/lsr", 1000000, [&](uint64_t n) {
+        uint32_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) sum += uart.readByte(Address(0x00, 5));
+        gSink = sum;
+    });
+    bench("uart/write/scr", 1000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) uart.storeByte(Address(0x00, 7), (uint8_t)i);
+    });
+    bench("uart/addCycles", 1000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) uart.addCycles(3);
+    });
+
+    // Status register flag updates.
+    CpuStatus status;
+    bench("status/updateSignAndZero8", 10000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) status.updateSignAndZeroFlagFrom8BitValue((uint8_t)i);
+        gSink = status.getRegisterValue();
+    });
+    bench("status/updateSignAndZero16", 10000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) status.updateSignAndZeroFlagFrom16BitValue((uint16_t)i);
+        gSink = status.getRegisterValue();
+    });
+    bench("status/setRegisterValue", 10000000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) status.setRegisterValue((uint8_t)i & 0x0F);
+        gSink = status.getRegisterValue();
+    });
+
+    // BCD arithmetic.
+    bench("binary/bcdSum8Bit", 10000000, [&](uint64_t n) {
+        uint8_t result = 0;
+        bool carry = false;
+        for (uint64_t i = 0; i < n; ++i) carry = Binary::bcdSum8Bit(0x45, result & 0x99, &result, carry);
+        gSink = result;
+    });
+    bench("binary/bcdSum16Bit", 10000000, [&](uint64_t n) {
+        uint16_t result = 0;
+        bool carry = false;
+        for (uint64_t i = 0; i < n; ++i) carry = Binary::bcdSum16Bit(0x1234, result & 0x9999, &result, carry);
+        gSink = result;
+    });
+
+    // CPU internals.
+    Cpu65816 cpu(bus);
+    Cpu65816Bench cpuBench(cpu, bus);
+    cpuBench.decode();
+    cpuBench.opcodes(true, true);
+    cpuBench.opcodes(true, false);
+    cpuBench.opcodes(false, true);
+    cpuBench.opcodes(false, false);
+
+    cpuBench.blockMove();
+}
+
+static void usage() {
+    std::cerr << "usage: sim65816_bench [-f filter] [-n repetitions] [-k scale] [-o output] [-g program]..." << std::endl
+              << "  -f filter       run only benchmarks whose name contains filter" << std::endl
+              << "  -n repetitions  timed runs of each benchmark (default 3)" << std::endl
+              << "  -k scale        multiply iteration counts by scale" << std::endl
+              << "  -o output       write JSON results to a file instead of standard output" << std::endl
+              << "  -g program      run a guest program loaded at $00:1000 until STP in each" << std::endl
+              << "                  execution mode, instead of the micro-benchmarks" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            gOptions.filter = argv[++i];
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            gOptions.repetitions = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "-k") && i + 1 < argc) {
+            gOptions.scale = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            gOptions.output = argv[++i];
+        } else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            gOptions.guests.push_back(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    // Keep device and CPU logging out of the timings.
+    Log::out(NULL_DEVICE);
+
+    if (!gOptions.guests.empty()) {
+        for (const char *guest : gOptions.guests) {
+            if (!runGuest(guest)) {
+                std::cerr << "sim65816_bench: cannot read " << guest << std::endl;
+                return 1;
+            }
+        }
+    } else {
+        runMicroBenchmarks();
+        // Only now is the image unmapped; Windows will not delete a
+        // mapped file.
+        std::remove(ROM_IMAGE);
+    }
+
+    Log::out();
+    if (gOptions.output) {
+        std::ofstream out(gOptions.output);
+        writeJson(out);
+    } else {
+        writeJson(std::cout);
+    }
+    return 0;
+}
@@ -18,58 +18,365 @@
 // along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Log.hpp"
-#include "Ram.hpp"
-#include "Rom.hpp"
-#include "Uart.hpp"
+#include "Terminal.hpp"
 
-#include "Interrupt.hpp"
-#include "SystemBus.hpp"
+#include "Machine.hpp"
+#include "MachineDescription.hpp"
 #include "Cpu65816.hpp"
 #include "Cpu65816Debugger.hpp"
+#include "CallGraph.hpp"
+#include "GdbServer.hpp"
+#include "HostServices.hpp"
+#include "InputLog.hpp"
+#include "IntelHex.hpp"
+#include "Metrics.hpp"
+#include "Profiler.hpp"
+#include "Rewind.hpp"
+#include "Sampler.hpp"
+#include "Symbols.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #define LOG_TAG "MAIN"
 
+// Cycles run between checks for a periodic metrics export.
+#define METRICS_SLICE_CYCLES 100000
+
+// Checkpoints kept for reverse execution when -H gives no count.
+#define HISTORY_CHECKPOINTS 100
+
+struct LoadOption {
+    std::string filename;
+    uint32_t address;
+};
+
+struct WatchOption {
+    Address first;
+    Address last;
+    uint8_t kinds;
+};
+
+static void usage() {
+    std::cerr << "usage: sim65816 [-m machine] [-b address]... [-r|-w|-c first[-last]]... [-p report] [-g stacks] [-C coverage]" << std::endl
+              << "                [-S samples [-I cycles]] [-s symbols]... [-l file[@address]]... [-e address] [-R|-P input] [-G socket [-H cycles[,count]]]" << std::endl
+              << "                [-M metrics [-T ms]] [-q] [-W]" << std::endl
+              << "  -m machine  read the memory map from a machine description (default dt65pc.machine)" << std::endl
+              << "  -l file     load a binary at @address, or an Intel HEX (.hex) file, before reset;" << std::endl
+              << "              @address is added to Intel HEX addresses" << std::endl
+              << "  -e address  start at an address instead of the reset vector, skipping POST" << std::endl
+              << "  -b address  stop at a breakpoint, as BB:OOOO or a 24-bit hex value" << std::endl
+              << "  -r range    stop on reads from an address range" << std::endl
+              << "  -w range    stop on writes to an address range" << std::endl
+              << "  -c range    stop when a write changes a value in an address range" << std::endl
+              << "  -p report   profile execution and write a hot-spot report on exit" << std::endl
+              << "  -g stacks   track calls and write cycles per call path in collapsed-stack" << std::endl
+              << "              form for flame-graph tools; adds a call graph to the -p report" << std::endl
+              << "  -C coverage write a map of executed instructions on exit" << std::endl
+              << "  -S samples  sample the PC and callers and write the samples on exit" << std::endl
+              << "  -I cycles   mean cycles between samples (default 1000)" << std::endl
+              << "  -s symbols  name addresses from an ld65 label (.lbl) or map (.map) file" << std::endl
+              << "              or a ca65 listing (.lst)" << std::endl
+              << "  -R input    record the bytes typed at the console, with their cycles" << std::endl
+              << "  -P input    replay recorded input instead of reading the console" << std::endl
+              << "  -G socket   wait for GDB on a loopback TCP port or Unix socket path and let it" << std::endl
+              << "              run the machine until it detaches" << std::endl
+              << "  -H cycles   under -G, keep a checkpoint every so many cycles, at most count of" << std::endl
+              << "              them (default 100), so GDB can step and continue backward" << std::endl
+              << "  -M metrics  write counters as JSON on exit to a file or listening Unix socket" << std::endl
+              << "  -T ms       also write the metrics every so many milliseconds" << std::endl
+              << "  -q          do not trace each instruction to the log" << std::endl
+              << "  -W          let WDM call host services such as ul2a" << std::endl;
+}
+
+static bool parseLoad(const char *text, LoadOption &load) {
+    load.filename = text;
+    load.address = 0;
+    const size_t at = load.filename.rfind('@');
+    if (at != std::string::npos) {
+        Address address;
+        if (!Address::parse(load.filename.c_str() + at + 1, address)) return false;
+        load.address = address.getAbsolute();
+        load.filename.resize(at);
+    } else if (!IntelHex::isHexFile(load.filename)) {
+        // A binary says nothing about where it goes.
+        return false;
+    }
+    return !load.filename.empty();
+}
+
+// Run until a stop, pausing now and then for a metrics export when they
+// are periodic.
+template <typename Hooks>
+static StopReason run(Cpu65816Debugger &debugger, Hooks &hooks, Metrics &metrics) {
+    if (!metrics.periodic()) return debugger.runUntil(hooks);
+    StopReason reason;
+    while ((reason = debugger.runUntil(hooks, METRICS_SLICE_CYCLES)) == StopReason::CycleBudget) {
+        metrics.poll();
+    }
+    return reason;
+}
+
+static bool parseRange(const char *text, Address &first, Address &last) {
+    std::string firstText(text);
+    std::string lastText;
+    size_t dash = firstText.find('-');
+    if (dash != std::string::npos) {
+        lastText = firstText.substr(dash + 1);
+        firstText.resize(dash);
+    }
+    if (!Address::parse(firstText.c_str(), first)) return false;
+    if (lastText.empty()) {
+        last = first;
+        return true;
+    }
+    return Address::parse(lastText.c_str(), last) && last.getAbsolute() >= first.getAbsolute();
+}
+
 int main(int argc, char **argv) {
+    std::vector<Address> breakPoints;
+    std::vector<WatchOption> watchPoints;
+    std::vector<LoadOption> loads;
+    Address entry;
+    bool haveEntry = false;
+    const char *profileReport = 0;
+    const char *callStacks = 0;
+    const char *coverageMap = 0;
+    const char *sampleBuffer = 0;
+    unsigned long sampleInterval = 1000;
+    bool quiet = false;
+    bool hostServices = false;
+    const char *recordInput = 0;
+    const char *replayInput = 0;
+    const char *gdbSocket = 0;
+    unsigned long historyInterval = 0;
+    unsigned long historyCount = HISTORY_CHECKPOINTS;
+    const char *metricsTarget = 0;
+    unsigned long metricsInterval = 0;
+    const char *machineFile = "dt65pc.machine";
+    Symbols symbols;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            machineFile = argv[++i];
+        } else if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+            Address address;
+            if (!Address::parse(argv[++i], address)) {
+                std::cerr << "sim65816: bad address " << argv[i] << std::endl;
+                return 1;
+            }
+            breakPoints.push_back(address);
+        } else if ((!strcmp(argv[i], "-r") || !strcmp(argv[i], "-w") || !strcmp(argv[i], "-c")) && i + 1 < argc) {
+            WatchOption watch;
+            watch.kinds = argv[i][1] == 'r' ? WATCH_READ : argv[i][1] == 'w' ? WATCH_WRITE : WATCH_CHANGE;
+            if (!parseRange(argv[++i], watch.first, watch.last)) {
+                std::cerr << "sim65816: bad address range " << argv[i] << std::endl;
+                return 1;
+            }
+            watchPoints.push_back(watch);
+        } else if (!strcmp(argv[i], "-l") && i + 1 < argc) {
+            LoadOption load;
+            if (!parseLoad(argv[++i], load)) {
+                std::cerr << "sim65816: expected -l file@address or -l file.hex, not " << argv[i] << std::endl;
+                return 1;
+            }
+            loads.push_back(load);
+        } else if (!strcmp(argv[i], "-e") && i + 1 < argc) {
+            if (!Address::parse(argv[++i], entry)) {
+                std::cerr << "sim65816: bad address " << argv[i] << std::endl;
+                return 1;
+            }
+            haveEntry = true;
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            profileReport = argv[++i];
+        } else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            callStacks = argv[++i];
+        } else if (!strcmp(argv[i], "-C") && i + 1 < argc) {
+            coverageMap = argv[++i];
+        } else if (!strcmp(argv[i], "-S") && i + 1 < argc) {
+            sampleBuffer = argv[++i];
+        } else if (!strcmp(argv[i], "-I") && i + 1 < argc) {
+            sampleInterval = strtoul(argv[++i], 0, 0);
+            if (sampleInterval == 0 || sampleInterval > 0xFFFFFFFF) {
+                std::cerr << "sim65816: bad sample interval " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "-R") && i + 1 < argc) {
+            recordInput = argv[++i];
+        } else if (!strcmp(argv[i], "-P") && i + 1 < argc) {
+            replayInput = argv[++i];
+        } else if (!strcmp(argv[i], "-G") && i + 1 < argc) {
+            gdbSocket = argv[++i];
+        } else if (!strcmp(argv[i], "-H") && i + 1 < argc) {
+            char *end;
+            historyInterval = strtoul(argv[++i], &end, 0);
+            if (*end == ',') historyCount = strtoul(end + 1, &end, 0);
+            if (historyInterval == 0 || historyCount == 0 || *end != '\0') {
+                std::cerr << "sim65816: expected -H cycles[,count], not " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "-M") && i + 1 < argc) {
+            metricsTarget = argv[++i];
+        } else if (!strcmp(argv[i], "-T") && i + 1 < argc) {
+            metricsInterval = strtoul(argv[++i], 0, 0);
+            if (metricsInterval == 0 || metricsInterval > 0xFFFFFFFF) {
+                std::cerr << "sim65816: bad metrics interval " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "-q")) {
+            quiet = true;
+        } else if (!strcmp(argv[i], "-W")) {
+            hostServices = true;
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            if (!symbols.load(argv[++i])) {
+                std::cerr << "sim65816: cannot read symbols from " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (historyInterval && !gdbSocket) {
+        std::cerr << "sim65816: -H needs -G" << std::endl;
+        return 1;
+    }
+
+    MachineDescription description;
+    std::string error;
+    if (!description.load(machineFile, error)) {
+        std::cerr << "sim65816: " << error << std::endl;
+        return 1;
+    }
+
     Log::out("dt65pc.log");
     Log::vrb(LOG_TAG).str("+++ DT65PC Simulation +++").show();
 
     Terminal term;
+    InputLog input;
+    if ((recordInput && !input.record(recordInput, error)) || (replayInput && !input.replay(replayInput, error))) {
+        Log::out();
+        std::cerr << "sim65816: " << error << std::endl;
+        return 1;
+    }
+
+    Machine machine;
+    if (!description.build(machine, &term, error, recordInput || replayInput ? &input : 0)) {
+        Log::out();
+        std::cerr << "sim65816: " << error << std::endl;
+        return 1;
+    }
+    for (const LoadOption &load : loads) {
+        if (!machine.load(load.filename, load.address, error)) {
+            Log::out();
+            std::cerr << "sim65816: " << error << std::endl;
+            return 1;
+        }
+        Log::vrb(LOG_TAG).str("Loaded ").str(load.filename.c_str()).show();
+    }
+    for (const WatchOption &watch : watchPoints) {
+        machine.bus().addWatchpoint(watch.first, watch.last, watch.kinds);
+    }
+
+    Cpu65816 &cpu = machine.cpu();
+    Profiler profiler;
+    if (profileReport) {
+        cpu.setProfiler(&profiler);
+    }
+    CallGraph callGraph;
+    if (callStacks) {
+        cpu.setCallGraph(&callGraph);
+    }
+    Coverage coverage;
+    if (coverageMap) {
+        cpu.setCoverage(&coverage);
+    }
+    Sampler sampler((uint32_t)sampleInterval);
+    if (sampleBuffer) {
+        cpu.setSampler(&sampler);
+    }
+    HostServices services;
+    if (hostServices) {
+        cpu.setHostServices(&services);
+    }
+    Metrics metrics(machine);
+    if (metricsTarget) {
+        if (!metrics.open(metricsTarget, error)) {
+            Log::out();
+            std::cerr << "sim65816: " << error << std::endl;
+            return 1;
+        }
+        metrics.setInterval((uint32_t)metricsInterval);
+    }
+    // One breakpoint set, the machine's, serves both the debugger and
+    // the GDB server.
+    Cpu65816Debugger debugger(cpu, machine.breakPoints());
+    for (const Address &address : breakPoints) {
+        debugger.setBreakPoint(address);
+    }
+    if (haveEntry) {
+        Cpu65816::Registers registers = cpu.getRegisters();
+        registers.pbr = entry.getBank();
+        registers.pc = entry.getOffset();
+        cpu.setRegisters(registers);
+        Log::vrb(LOG_TAG).str("Starting at ").hex(entry.getAbsolute(), 6).show();
+    }
 
-    Rom kernel(Address(0x00, 0xC000), "..\\kernel\\dt65pc.rom");
-    Rom math0(Address(0xE0, 0x0000), "..\\kernel\\rom0.rom");
-    Rom math1(Address(0xF0, 0x0000), "..\\kernel\\rom1.rom");
-    UartPC16550D uart0(Address(0x00, 0xB000), &term);
-    UartPC16550D uart1(Address(0x00, 0xB100));
-    Ram ram = Ram(0x80);
-
-    SystemBus systemBus = SystemBus();
-    systemBus.registerDevice(&kernel);
-    systemBus.registerDevice(&math0);
-    systemBus.registerDevice(&math1);
-    systemBus.registerDevice(&uart0);
-    systemBus.registerDevice(&uart1);
-    systemBus.registerDevice(&ram);
-
-    Cpu65816 cpu(systemBus);
-    Cpu65816Debugger debugger(cpu);
-    debugger.doBeforeStep([]() {});
-    debugger.doAfterStep([]() {});
-
-    bool breakPointHit = false;
-    debugger.onBreakPoint([&breakPointHit]()  {
-        breakPointHit = true;
-    });
-    debugger.onStp([&breakPointHit]() {
-        breakPointHit = true;
-    });
-
-    while (!breakPointHit) {
-        debugger.step();
-    }
-
-    Log::vrb(LOG_TAG).str("+++ DT65PC Stopped +++").show();
+    StopReason reason;
+    if (gdbSocket) {
+        GdbServer server(machine);
+        std::unique_ptr<Rewind> rewind;
+        if (historyInterval) {
+            rewind.reset(new Rewind(machine, historyInterval, historyCount));
+            server.setRewind(rewind.get());
+        }
+        if (metrics.periodic()) server.setMetrics(&metrics);
+        if (!server.listen(gdbSocket, error) || !server.serve(error)) {
+            Log::out();
+            std::cerr << "sim65816: " << error << std::endl;
+            return 1;
+        }
+        reason = server.lastStop();
+    } else if (quiet || !description.trace()) {
+        NoHooks hooks;
+        reason = run(debugger, hooks, metrics);
+    } else {
+        TraceHooks hooks;
+        reason = run(debugger, hooks, metrics);
+    }
+
+    Log::vrb(LOG_TAG).str("+++ DT65PC Stopped +++ ").str(stopReasonName(reason)).show();
+    Log::vrb(LOG_TAG).dec(cpu.getTotalInstructions()).str(" instructions in ")
+        .dec(cpu.getTotalCycles()).str(" cycles, ")
+        .dec(cpu.getTotalCycles() * 1000 / description.clock()).str(" ms at ")
+        .dec(description.clock()).str(" Hz").show();
     debugger.dumpCpu();
     Log::out();
+
+    callGraph.update(cpu.getTotalCycles());
+    if (profileReport) {
+        std::ofstream report(profileReport);
+        profiler.report(report, symbols);
+        if (callStacks) callGraph.report(report, symbols);
+    }
+    if (callStacks) {
+        std::ofstream stacks(callStacks);
+        callGraph.writeCollapsed(stacks, symbols);
+    }
+    if (coverageMap && !coverage.save(coverageMap)) {
+        std::cerr << "sim65816: cannot write " << coverageMap << std::endl;
+    }
+    if (sampleBuffer && !sampler.save(sampleBuffer)) {
+        std::cerr << "sim65816: cannot write " << sampleBuffer << std::endl;
+    }
+    if (metricsTarget && !metrics.write()) {
+        std::cerr << "sim65816: cannot write metrics to " << metricsTarget << std::endl;
+    }
     
     debugger.dumpCpu();
 }
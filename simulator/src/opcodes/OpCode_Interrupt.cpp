@@ -47,6 +47,7 @@ void Cpu65816::executeInterrupt(OpCode &opCode) {
             mCpuStatus.setInterruptDisableFlag();
             mCpuStatus.clearDecimalFlag();
             setProgramAddress(Address(0x00, mSystemBus.readTwoBytes(vectorAddress)));
+            traceCall();
             break;
         }
         case(0x02):                 // COP
@@ -66,6 +67,7 @@ void Cpu65816::executeInterrupt(OpCode &opCode) {
                 addToCycles(8);
             }
             mCpuStatus.clearDecimalFlag();
+            traceCall();
             break;
         }
         case(0x40):                 // RTI
@@ -85,6 +87,7 @@ void Cpu65816::executeInterrupt(OpCode &opCode) {
                 mProgramAddress = newProgramAddress;
                 addToCycles(7);
             }
+            traceReturn();
             break;
         }
         default: {
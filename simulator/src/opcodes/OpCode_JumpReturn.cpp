@@ -35,6 +35,7 @@ void Cpu65816::executeJumpReturn(OpCode &opCode) {
             uint16_t destinationAddress = getAddressOfOpCodeData(opCode).getOffset();
             setProgramAddress(Address(mProgramAddress.getBank(), destinationAddress));
             addToCycles(6);
+            traceCall();
             break;
         }
         case(0x22):  // JSR Absolute Long
@@ -43,6 +44,7 @@ void Cpu65816::executeJumpReturn(OpCode &opCode) {
             mStack.push16Bit(mProgramAddress.getOffset() + 3);
             setProgramAddress(getAddressOfOpCodeData(opCode));
             addToCycles(8);
+            traceCall();
             break;
         }
         case(0xFC):  // JSR Absolute Indexed Indirect, X
@@ -51,6 +53,7 @@ void Cpu65816::executeJumpReturn(OpCode &opCode) {
             mStack.push16Bit(mProgramAddress.getOffset() + 2);
             setProgramAddress(destinationAddress);
             addToCycles(8);
+            traceCall();
             break;
         }
         case(0x4C):  // JMP Absolute
@@ -95,6 +98,7 @@ void Cpu65816::executeJumpReturn(OpCode &opCode) {
             Address returnAddress(newBank, newOffset);
             setProgramAddress(returnAddress);
             addToCycles(6);
+            traceReturn();
             break;
         }
         case(0x60):                 // RTS
@@ -102,6 +106,7 @@ void Cpu65816::executeJumpReturn(OpCode &opCode) {
             Address returnAddress(mProgramAddress.getBank(), mStack.pull16Bit() + 1);
             setProgramAddress(returnAddress);
             addToCycles(6);
+            traceReturn();
             break;
         }
         default: {
@@ -19,6 +19,7 @@
  */
 
 #include "Cpu65816.hpp"
+#include "HostServices.hpp"
 
 #define LOG_TAG "Cpu::executeMisc"
 
@@ -53,6 +54,7 @@ void Cpu65816::executeMisc(OpCode &opCode) {
         case(0xCB):     // WAI
         {
             setRDYPin(false);
+            ++mWaitCounter;
 
             addToProgramAddress(1);
             addToCycles(3);
@@ -60,6 +62,20 @@ void Cpu65816::executeMisc(OpCode &opCode) {
         }
         case(0x42):     // WDM
         {
+            // The signature byte selects a host service. A handled call
+            // clears carry; otherwise WDM is a no-op.
+            if (mHostServices) {
+                const uint8_t signature = mSystemBus.readByte(Address::sumOffsetToAddressWrapAround(mProgramAddress, 1));
+                Registers registers = getRegisters();
+                uint32_t cycles;
+                if (mHostServices->call(signature, registers, mSystemBus, cycles)) {
+                    mA = registers.a;
+                    mX = registers.x;
+                    mY = registers.y;
+                    mCpuStatus.clearCarryFlag();
+                    addToCycles(cycles);
+                }
+            }
             addToProgramAddress(2);
             addToCycles(2);
             break;
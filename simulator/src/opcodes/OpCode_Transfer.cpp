@@ -78,7 +78,7 @@ void Cpu65816::executeTransfer(OpCode &opCode) {
             } else {
                 currentStackPointer = mA;
             }
-            mStack = Stack(&mSystemBus, currentStackPointer);
+            mStack.setStackPointer(currentStackPointer);
 
             addToProgramAddressAndCycles(1, 2);
             break;
@@ -154,11 +154,11 @@ void Cpu65816::executeTransfer(OpCode &opCode) {
             if (mCpuStatus.emulationFlag()) {
                 uint16_t newStackPointer = 0x100;
                 newStackPointer |= Binary::lower8BitsOf(mX);
-                mStack = Stack(&mSystemBus, newStackPointer);
+                mStack.setStackPointer(newStackPointer);
             } else if (!mCpuStatus.emulationFlag() && indexIs8BitWide()) {
-                mStack = Stack(&mSystemBus, Binary::lower8BitsOf(mX));
+                mStack.setStackPointer(Binary::lower8BitsOf(mX));
             } else if (!mCpuStatus.emulationFlag() && indexIs16BitWide()) {
-                mStack = Stack(&mSystemBus, mX);
+                mStack.setStackPointer(mX);
             }
             addToProgramAddressAndCycles(1, 2);
             break;
@@ -0,0 +1,633 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+// Single-step conformance runner. Executes one instruction per test
+// vector on the CPU core and reports mismatches by opcode and register
+// width.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Cpu65816.hpp"
+#include "Disassembler.hpp"
+#include "Log.hpp"
+#include "SystemBus.hpp"
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Magic bytes at the start of a binary vector file.
+#define VECTOR_MAGIC "DT65VEC1"
+#define VECTOR_MAGIC_SIZE 8
+
+// Register width modes a case can start in.
+#define MODE_COUNT 5
+
+// Status bits with no storage in emulation mode.
+#define EMULATION_UNUSED_BITS 0x30
+
+namespace {
+
+const char *const MODE_NAMES[MODE_COUNT] = {
+    "e", "m16x16", "m16x8", "m8x16", "m8x8"
+};
+
+struct Memory {
+    uint32_t address;
+    uint8_t value;
+};
+
+struct State {
+    Cpu65816::Registers registers;
+    std::vector<Memory> ram;
+};
+
+struct TestCase {
+    std::string name;
+    State initial;
+    State final;
+    uint32_t cycles;
+};
+
+// Results for one opcode in one width mode.
+struct Tally {
+    uint64_t cases = 0;
+    uint64_t failed = 0;
+    uint64_t registers = 0;
+    uint64_t memory = 0;
+    uint64_t cycles = 0;
+    // First failure in input order, as file and case index.
+    size_t firstFile = SIZE_MAX;
+    size_t firstCase = SIZE_MAX;
+    std::string first;
+};
+
+struct Options {
+    bool checkCycles = true;
+    bool all = false;
+    bool verbose = false;
+    bool writeBinary = false;
+    unsigned threads = 0;
+    std::vector<std::string> files;
+};
+
+Options gOptions;
+
+/// @brief Flat 16MB memory covering the whole address space.
+/// @details
+/// Every store is recorded so that the next case can start from zeroed
+/// memory without clearing all of it, and so that stores the vector does
+/// not expect are caught.
+class TestBus : public SystemBusDevice {
+public:
+    TestBus() : mMemory(0x1000000, 0) {}
+
+    void storeByte(const Address &addr, uint8_t val) {
+        mMemory[addr.getAbsolute()] = val;
+        mWritten.push_back(addr.getAbsolute());
+    }
+
+    uint8_t readByte(const Address &addr) {
+        return mMemory[addr.getAbsolute()];
+    }
+
+    bool decodeAddress(const Address &in, Address &out) {
+        out = in;
+        return true;
+    }
+
+    /// @brief Access memory without recording a store.
+    uint8_t &at(uint32_t addr) { return mMemory[addr & 0xFFFFFF]; }
+
+    /// @brief Addresses stored to since the last clear.
+    const std::vector<uint32_t> &written() const { return mWritten; }
+
+    /// @brief Zero the given addresses and everything stored to.
+    void clear(const std::vector<Memory> &ram) {
+        for (const Memory &memory : ram) mMemory[memory.address] = 0;
+        for (uint32_t addr : mWritten) mMemory[addr] = 0;
+        mWritten.clear();
+    }
+
+private:
+    std::vector<uint8_t> mMemory;
+    std::vector<uint32_t> mWritten;
+};
+
+/// @brief Minimal reader for the JSON subset used by test vectors:
+/// objects, arrays, strings without escapes beyond \" and \\, unsigned
+/// integers and literals.
+class JsonReader {
+public:
+    JsonReader(const char *begin, const char *end) : mPos(begin), mEnd(end) {}
+
+    bool atEnd() {
+        skipSpace();
+        return mPos == mEnd;
+    }
+
+    // Consume a character if it is next.
+    bool consume(char c) {
+        skipSpace();
+        if (mPos == mEnd || *mPos != c) return false;
+        ++mPos;
+        return true;
+    }
+
+    bool readString(std::string &out) {
+        if (!consume('"')) return false;
+        out.clear();
+        while (mPos != mEnd && *mPos != '"') {
+            if (*mPos == '\\' && mPos + 1 != mEnd) ++mPos;
+            out += *mPos++;
+        }
+        if (mPos == mEnd) return false;
+        ++mPos;
+        return true;
+    }
+
+    bool readNumber(uint32_t &out) {
+        skipSpace();
+        if (mPos == mEnd || !isdigit((unsigned char)*mPos)) return false;
+        out = 0;
+        while (mPos != mEnd && isdigit((unsigned char)*mPos)) out = out * 10 + (*mPos++ - '0');
+        return true;
+    }
+
+    bool skipValue() {
+        skipSpace();
+        if (mPos == mEnd) return false;
+        if (*mPos == '"') {
+            std::string ignored;
+            return readString(ignored);
+        }
+        if (*mPos == '[') return readArray([this]() { return skipValue(); });
+        if (*mPos == '{') return readObject([this](const std::string &) { return skipValue(); });
+        // Numbers, including signs and fractions, and literals.
+        const char *start = mPos;
+        while (mPos != mEnd && (isalnum((unsigned char)*mPos) || strchr("+-.", *mPos))) ++mPos;
+        return mPos != start;
+    }
+
+    /// @brief Read an array, calling element() to read each element.
+    template <typename Element>
+    bool readArray(Element element) {
+        if (!consume('[')) return false;
+        if (consume(']')) return true;
+        do {
+            if (!element()) return false;
+        } while (consume(','));
+        return consume(']');
+    }
+
+    /// @brief Read an object, calling member(key) to read each value.
+    template <typename Member>
+    bool readObject(Member member) {
+        if (!consume('{')) return false;
+        if (consume('}')) return true;
+        do {
+            std::string key;
+            if (!readString(key) || !consume(':') || !member(key)) return false;
+        } while (consume(','));
+        return consume('}');
+    }
+
+private:
+    const char *mPos;
+    const char *mEnd;
+
+    void skipSpace() {
+        while (mPos != mEnd && isspace((unsigned char)*mPos)) ++mPos;
+    }
+};
+
+bool readState(JsonReader &json, State &state) {
+    Cpu65816::Registers &r = state.registers;
+    r = Cpu65816::Registers();
+    return json.readObject([&](const std::string &key) {
+        uint32_t value = 0;
+        if (key == "ram") {
+            return json.readArray([&]() {
+                uint32_t address, byte;
+                if (!json.consume('[') || !json.readNumber(address) || !json.consume(',')
+                        || !json.readNumber(byte) || !json.consume(']')) {
+                    return false;
+                }
+                state.ram.push_back(Memory { address & 0xFFFFFF, (uint8_t)byte });
+                return true;
+            });
+        }
+        if (key == "pc") { if (!json.readNumber(value)) return false; r.pc = value; }
+        else if (key == "s") { if (!json.readNumber(value)) return false; r.s = value; }
+        else if (key == "p") { if (!json.readNumber(value)) return false; r.p = value; }
+        else if (key == "a") { if (!json.readNumber(value)) return false; r.a = value; }
+        else if (key == "x") { if (!json.readNumber(value)) return false; r.x = value; }
+        else if (key == "y") { if (!json.readNumber(value)) return false; r.y = value; }
+        else if (key == "dbr") { if (!json.readNumber(value)) return false; r.dbr = value; }
+        else if (key == "d") { if (!json.readNumber(value)) return false; r.d = value; }
+        else if (key == "pbr") { if (!json.readNumber(value)) return false; r.pbr = value; }
+        else if (key == "e") { if (!json.readNumber(value)) return false; r.e = value != 0; }
+        else return json.skipValue();
+        return true;
+    });
+}
+
+/// @brief Parse a JSON vector file: an array of cases, each with a name,
+/// initial and final state, and one cycles entry per bus cycle.
+bool parseJson(const std::string &text, std::vector<TestCase> &cases) {
+    JsonReader json(text.data(), text.data() + text.size());
+    const bool ok = json.readArray([&]() {
+        TestCase test;
+        test.cycles = 0;
+        if (!json.readObject([&](const std::string &key) {
+                if (key == "name") return json.readString(test.name);
+                if (key == "initial") return readState(json, test.initial);
+                if (key == "final") return readState(json, test.final);
+                if (key == "cycles") {
+                    return json.readArray([&]() {
+                        ++test.cycles;
+                        return json.skipValue();
+                    });
+                }
+                return json.skipValue();
+            })) {
+            return false;
+        }
+        cases.push_back(std::move(test));
+        return true;
+    });
+    return ok && json.atEnd();
+}
+
+// Binary vectors are little-endian records of the same fields.
+class BinaryReader {
+public:
+    BinaryReader(const std::string &data, size_t pos) : mData(data), mPos(pos) {}
+
+    bool atEnd() const { return mPos >= mData.size(); }
+
+    bool read(uint32_t &out, int bytes) {
+        if (mPos + bytes > mData.size()) return false;
+        out = 0;
+        for (int i = 0; i < bytes; ++i) out |= (uint32_t)(uint8_t)mData[mPos++] << (8 * i);
+        return true;
+    }
+
+    bool readString(std::string &out, size_t length) {
+        if (mPos + length > mData.size()) return false;
+        out.assign(mData, mPos, length);
+        mPos += length;
+        return true;
+    }
+
+private:
+    const std::string &mData;
+    size_t mPos;
+};
+
+bool readState(BinaryReader &in, State &state) {
+    Cpu65816::Registers &r = state.registers;
+    uint32_t pc, s, p, a, x, y, dbr, d, pbr, e, count;
+    if (!in.read(pc, 2) || !in.read(s, 2) || !in.read(p, 1) || !in.read(a, 2) || !in.read(x, 2)
+            || !in.read(y, 2) || !in.read(dbr, 1) || !in.read(d, 2) || !in.read(pbr, 1)
+            || !in.read(e, 1) || !in.read(count, 2)) {
+        return false;
+    }
+    r.pc = pc; r.s = s; r.p = p; r.a = a; r.x = x; r.y = y;
+    r.dbr = dbr; r.d = d; r.pbr = pbr; r.e = e != 0;
+    state.ram.resize(count);
+    for (Memory &memory : state.ram) {
+        uint32_t address, value;
+        if (!in.read(address, 3) || !in.read(value, 1)) return false;
+        memory = Memory { address, (uint8_t)value };
+    }
+    return true;
+}
+
+bool parseBinary(const std::string &data, std::vector<TestCase> &cases) {
+    BinaryReader in(data, VECTOR_MAGIC_SIZE);
+    while (!in.atEnd()) {
+        TestCase test;
+        uint32_t length;
+        if (!in.read(length, 1) || !in.readString(test.name, length)
+                || !readState(in, test.initial) || !readState(in, test.final)
+                || !in.read(test.cycles, 2)) {
+            return false;
+        }
+        cases.push_back(std::move(test));
+    }
+    return true;
+}
+
+void write(std::ostream &out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.put((char)(value >> (8 * i)));
+}
+
+void writeState(std::ostream &out, const State &state) {
+    const Cpu65816::Registers &r = state.registers;
+    write(out, r.pc, 2); write(out, r.s, 2); write(out, r.p, 1); write(out, r.a, 2);
+    write(out, r.x, 2); write(out, r.y, 2); write(out, r.dbr, 1); write(out, r.d, 2);
+    write(out, r.pbr, 1); write(out, r.e, 1);
+    write(out, state.ram.size(), 2);
+    for (const Memory &memory : state.ram) {
+        write(out, memory.address, 3);
+        write(out, memory.value, 1);
+    }
+}
+
+bool writeBinary(const std::string &filename, const std::vector<TestCase> &cases) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) return false;
+    out.write(VECTOR_MAGIC, VECTOR_MAGIC_SIZE);
+    for (const TestCase &test : cases) {
+        write(out, std::min<size_t>(test.name.size(), 255), 1);
+        out.write(test.name.data(), std::min<size_t>(test.name.size(), 255));
+        writeState(out, test.initial);
+        writeState(out, test.final);
+        write(out, test.cycles, 2);
+    }
+    return (bool)out;
+}
+
+/// @brief Load a vector file, telling the formats apart by the magic.
+bool loadVectors(const std::string &filename, std::vector<TestCase> &cases) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return false;
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.compare(0, VECTOR_MAGIC_SIZE, VECTOR_MAGIC) == 0) return parseBinary(data, cases);
+    return parseJson(data, cases);
+}
+
+std::string binaryName(const std::string &filename) {
+    const size_t dot = filename.rfind('.');
+    const size_t slash = filename.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return filename + ".bin";
+    return filename.substr(0, dot) + ".bin";
+}
+
+int modeOf(const Cpu65816::Registers &registers) {
+    if (registers.e) return 0;
+    return 1 + ((registers.p & 0x20) ? 2 : 0) + ((registers.p & 0x10) ? 1 : 0);
+}
+
+/// @brief One CPU on its own test bus, running cases from whole files.
+class Worker {
+public:
+    Worker() : mCpu(mSystemBus), mTallies(256 * MODE_COUNT) {
+        mSystemBus.registerDevice(&mTestBus);
+    }
+
+    /// @brief Run every case in a file.
+    /// @return false if the file could not be loaded
+    bool runFile(size_t fileIndex, const std::string &filename) {
+        std::vector<TestCase> cases;
+        if (!loadVectors(filename, cases)) return false;
+        if (gOptions.writeBinary && !writeBinary(binaryName(filename), cases)) return false;
+        for (size_t i = 0; i < cases.size(); ++i) runCase(fileIndex, i, cases[i]);
+        return true;
+    }
+
+    const std::vector<Tally> &tallies() const { return mTallies; }
+
+private:
+    SystemBus mSystemBus;
+    TestBus mTestBus;
+    Cpu65816 mCpu;
+    std::vector<Tally> mTallies;
+
+    void runCase(size_t fileIndex, size_t caseIndex, const TestCase &test) {
+        const Cpu65816::Registers &initial = test.initial.registers;
+        for (const Memory &memory : test.initial.ram) mTestBus.at(memory.address) = memory.value;
+        const uint8_t opcode = mTestBus.at((uint32_t)initial.pbr << 16 | initial.pc);
+
+        // Cycling reset brings the CPU back after STP.
+        mCpu.setRESPin(true);
+        mCpu.setRESPin(false);
+        mCpu.setRegisters(initial);
+        const uint64_t start = mCpu.getTotalCycles();
+        mCpu.executeNextInstruction();
+        const uint64_t cycles = mCpu.getTotalCycles() - start;
+
+        std::ostringstream detail;
+        detail << std::hex << std::uppercase;
+        const bool registersMatch = compareRegisters(mCpu.getRegisters(), test.final.registers, detail);
+        const bool memoryMatches = compareMemory(test.final.ram, detail);
+        const bool cyclesMatch = !gOptions.checkCycles || cycles == test.cycles;
+        if (!cyclesMatch) detail << std::dec << " cycles=" << cycles << " want " << test.cycles;
+
+        Tally &tally = mTallies[opcode * MODE_COUNT + modeOf(initial)];
+        ++tally.cases;
+        if (!registersMatch || !memoryMatches || !cyclesMatch) {
+            ++tally.failed;
+            if (!registersMatch) ++tally.registers;
+            if (!memoryMatches) ++tally.memory;
+            if (!cyclesMatch) ++tally.cycles;
+            if (tally.first.empty()) {
+                tally.firstFile = fileIndex;
+                tally.firstCase = caseIndex;
+                tally.first = test.name + ":" + detail.str();
+            }
+        }
+        mTestBus.clear(test.initial.ram);
+    }
+
+    static bool compareField(const char *name, uint32_t actual, uint32_t expected, std::ostream &detail) {
+        if (actual == expected) return true;
+        detail << " " << name << "=$" << actual << " want $" << expected;
+        return false;
+    }
+
+    static bool compareRegisters(const Cpu65816::Registers &actual, const Cpu65816::Registers &expected,
+            std::ostream &detail) {
+        // Emulation mode has no M and X bits to compare.
+        const uint8_t mask = expected.e ? (uint8_t)~EMULATION_UNUSED_BITS : 0xFF;
+        bool match = compareField("a", actual.a, expected.a, detail);
+        match &= compareField("x", actual.x, expected.x, detail);
+        match &= compareField("y", actual.y, expected.y, detail);
+        match &= compareField("s", actual.s, expected.s, detail);
+        match &= compareField("d", actual.d, expected.d, detail);
+        match &= compareField("pc", actual.pc, expected.pc, detail);
+        match &= compareField("p", actual.p & mask, expected.p & mask, detail);
+        match &= compareField("dbr", actual.dbr, expected.dbr, detail);
+        match &= compareField("pbr", actual.pbr, expected.pbr, detail);
+        match &= compareField("e", actual.e, expected.e, detail);
+        return match;
+    }
+
+    bool compareMemory(const std::vector<Memory> &expected, std::ostream &detail) {
+        bool match = true;
+        for (const Memory &memory : expected) {
+            const uint8_t actual = mTestBus.at(memory.address);
+            if (actual != memory.value) {
+                detail << " [$" << memory.address << "]=$" << (int)actual << " want $" << (int)memory.value;
+                match = false;
+            }
+        }
+        // Stores outside the expected memory are failures too.
+        for (uint32_t addr : mTestBus.written()) {
+            auto it = std::find_if(expected.begin(), expected.end(),
+                [addr](const Memory &memory) { return memory.address == addr; });
+            if (it == expected.end()) {
+                detail << " stray store to $" << addr;
+                match = false;
+                break;
+            }
+        }
+        return match;
+    }
+};
+
+void merge(std::vector<Tally> &total, const std::vector<Tally> &tallies) {
+    for (size_t i = 0; i < total.size(); ++i) {
+        Tally &sum = total[i];
+        const Tally &part = tallies[i];
+        sum.cases += part.cases;
+        sum.failed += part.failed;
+        sum.registers += part.registers;
+        sum.memory += part.memory;
+        sum.cycles += part.cycles;
+        if (!part.first.empty() && (part.firstFile < sum.firstFile
+                || (part.firstFile == sum.firstFile && part.firstCase < sum.firstCase))) {
+            sum.firstFile = part.firstFile;
+            sum.firstCase = part.firstCase;
+            sum.first = part.first;
+        }
+    }
+}
+
+void report(std::ostream &out, const std::vector<Tally> &tallies, double seconds) {
+    Tally total;
+    out << "Opcode        Mode       Cases   Failed     Regs   Memory   Cycles" << std::endl;
+    for (int opcode = 0; opcode < 256; ++opcode) {
+        for (int mode = 0; mode < MODE_COUNT; ++mode) {
+            const Tally &tally = tallies[opcode * MODE_COUNT + mode];
+            total.cases += tally.cases;
+            total.failed += tally.failed;
+            total.registers += tally.registers;
+            total.memory += tally.memory;
+            total.cycles += tally.cycles;
+            if (tally.cases == 0 || (tally.failed == 0 && !gOptions.all)) continue;
+
+            out << "$" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << opcode
+                << std::dec << std::setfill(' ') << " " << std::left
+                << std::setw(4) << Disassembler::OP_CODE_INFO[opcode].mnemonic << "     "
+                << std::setw(7) << MODE_NAMES[mode] << std::right
+                << std::setw(9) << tally.cases << std::setw(9) << tally.failed
+                << std::setw(9) << tally.registers << std::setw(9) << tally.memory
+                << std::setw(9) << tally.cycles << std::endl;
+            if (gOptions.verbose && !tally.first.empty()) out << "    " << tally.first << std::endl;
+        }
+    }
+    out << total.cases << " cases, " << total.failed << " failed ("
+        << total.registers << " register, " << total.memory << " memory, "
+        << total.cycles << " cycle mismatches) in "
+        << std::fixed << std::setprecision(2) << seconds << " s" << std::endl;
+}
+
+} // namespace
+
+static void usage() {
+    std::cerr << "usage: conform65816 [-j threads] [-c] [-a] [-v] [-w] vectors..." << std::endl
+              << "  -j threads  worker threads, default one per core" << std::endl
+              << "  -c          do not compare cycle counts" << std::endl
+              << "  -a          list every opcode and mode run, not only failures" << std::endl
+              << "  -v          show the first failing case of each opcode and mode" << std::endl
+              << "  -w          write a binary copy of each vector file, with extension .bin" << std::endl
+              << "Vector files are JSON arrays of single-step cases or binary files written by -w." << std::endl;
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "-j") && i + 1 < argc) {
+            gOptions.threads = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(arg, "-c")) {
+            gOptions.checkCycles = false;
+        } else if (!strcmp(arg, "-a")) {
+            gOptions.all = true;
+        } else if (!strcmp(arg, "-v")) {
+            gOptions.verbose = true;
+        } else if (!strcmp(arg, "-w")) {
+            gOptions.writeBinary = true;
+        } else if (arg[0] != '-') {
+            gOptions.files.push_back(arg);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (gOptions.files.empty()) {
+        usage();
+        return 2;
+    }
+
+    // Register changes such as TCS are traced; keep them quiet.
+    Log::out(NULL_DEVICE);
+
+    unsigned threads = gOptions.threads ? gOptions.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min<unsigned>(threads, gOptions.files.size()));
+
+    // Workers take whole files, so each parses and runs its own.
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> nextFile(0);
+    std::mutex mutex;
+    std::vector<Tally> tallies(256 * MODE_COUNT);
+    std::vector<std::string> unreadable;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            Worker worker;
+            for (size_t i = nextFile++; i < gOptions.files.size(); i = nextFile++) {
+                if (!worker.runFile(i, gOptions.files[i])) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    unreadable.push_back(gOptions.files[i]);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            merge(tallies, worker.tallies());
+        });
+    }
+    for (std::thread &thread : pool) thread.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Log::out();
+
+    for (const std::string &filename : unreadable) {
+        std::cerr << "conform65816: cannot read vectors from " << filename << std::endl;
+    }
+    report(std::cout, tallies, seconds);
+    if (!unreadable.empty()) return 2;
+    for (const Tally &tally : tallies) {
+        if (tally.failed) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,277 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+// Reverse execution check. Runs a small program that reads bytes from a
+// replayed console log, calls a subroutine and pushes to the stack,
+// recording the registers and memory after every instruction. Then goes
+// back with Rewind and compares what it restores with what was recorded.
+// A second program writes two disk sectors through the window, which
+// must both be put back.
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BlockDevice.hpp"
+#include "InputLog.hpp"
+#include "Log.hpp"
+#include "Machine.hpp"
+#include "Rewind.hpp"
+#include "Uart.hpp"
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Where the program and the console sit.
+#define PROGRAM_ADDRESS 0x1000
+#define SUBROUTINE_ADDRESS 0x1020
+#define BUFFER_ADDRESS 0x2000
+#define UART_ADDRESS 0xB000
+
+// Memory compared: direct page, stack, program and buffer.
+#define CHECKED_BYTES 0x2100
+
+// Bytes in the input log, and cycles between them.
+#define INPUT_BYTES 8
+#define INPUT_SPACING 1000
+
+// Few enough cycles between checkpoints that going back replays from
+// several of them, and more checkpoints than the run needs.
+#define CHECKPOINT_INTERVAL 200
+#define CHECKPOINT_COUNT 1000
+
+// Far more cycles than the whole program takes, so a run that waits for
+// input that never comes fails rather than hangs.
+#define RUN_CYCLES (4 * INPUT_BYTES * INPUT_SPACING)
+
+#define INPUT_LOG_FILE "rewind65816.log"
+
+// Two zeroed sectors, with the window at $C200.
+#define DISK_IMAGE_FILE "rewind65816.img"
+#define DISK_ADDRESS 0xC000
+#define DISK_IMAGE_SECTORS 2
+
+namespace {
+
+// Read INPUT_BYTES bytes from the UART into the buffer, pushing each and
+// calling a subroutine that counts them in $10.
+const uint8_t PROGRAM[] = {
+    0xA2, 0x00,             // 1000 LDX #$00
+    0xAD, 0x05, 0xB0,       // 1002 LDA $B005
+    0x29, 0x01,             // 1005 AND #$01
+    0xF0, 0xF9,             // 1007 BEQ $1002
+    0xAD, 0x00, 0xB0,       // 1009 LDA $B000
+    0x9D, 0x00, 0x20,       // 100C STA $2000,X
+    0x48,                   // 100F PHA
+    0x20, 0x20, 0x10,       // 1010 JSR $1020
+    0xE8,                   // 1013 INX
+    0xE0, INPUT_BYTES,      // 1014 CPX #INPUT_BYTES
+    0xD0, 0xEA,             // 1016 BNE $1002
+    0xDB,                   // 1018 STP
+};
+
+const uint8_t SUBROUTINE[] = {
+    0xE6, 0x10,             // 1020 INC $10
+    0x60,                   // 1022 RTS
+};
+
+typedef std::vector<uint8_t> State;
+
+int gFailures = 0;
+
+State capture(Machine &machine) {
+    const Cpu65816::Registers registers = machine.cpu().getRegisters();
+    const uint16_t words[] = { registers.a, registers.x, registers.y, registers.s, registers.d, registers.pc };
+    State state;
+    for (uint16_t word : words) {
+        state.push_back((uint8_t)word);
+        state.push_back((uint8_t)(word >> 8));
+    }
+    state.push_back(registers.p);
+    state.push_back(registers.dbr);
+    state.push_back(registers.pbr);
+    state.push_back(registers.e);
+    for (uint32_t address = 0; address < CHECKED_BYTES; ++address) {
+        state.push_back((uint8_t)machine.bus().peekByte(address));
+    }
+    return state;
+}
+
+void check(bool ok, const char *what) {
+    if (ok) return;
+    std::printf("rewind65816: FAIL %s\n", what);
+    ++gFailures;
+}
+
+// Compare the machine with the state recorded at its instruction count.
+void checkState(Machine &machine, const std::vector<State> &history, const char *what) {
+    const uint64_t instruction = machine.cpu().getTotalInstructions();
+    check(instruction < history.size() && capture(machine) == history[instruction], what);
+}
+
+// Write $AA to sector 0 and $BB to sector 1, selecting each in turn.
+const uint8_t DISK_PROGRAM[] = {
+    0xA9, 0xAA,             // 1000 LDA #$AA
+    0x8D, 0x00, 0xC2,       // 1002 STA $C200
+    0xA9, 0x01,             // 1005 LDA #$01
+    0x8D, 0x00, 0xC0,       // 1007 STA $C000
+    0x8D, 0x04, 0xC0,       // 100A STA $C004 (DISK_SELECT)
+    0xA9, 0xBB,             // 100D LDA #$BB
+    0x8D, 0x00, 0xC2,       // 100F STA $C200
+    0xDB,                   // 1012 STP
+};
+
+// First byte of a sector, selected from outside the program.
+uint8_t sectorByte(Machine &machine, uint8_t sector) {
+    machine.bus().storeByte(Address(0x00, DISK_ADDRESS + DISK_LBA), sector);
+    machine.bus().storeByte(Address(0x00, DISK_ADDRESS + DISK_COMMAND), DISK_SELECT);
+    return (uint8_t)machine.bus().peekByte(DISK_ADDRESS + DISK_WINDOW);
+}
+
+// Moving the window to another sector within a checkpoint interval must
+// not hide that sector's first write from the checkpoint.
+void checkDiskWindow() {
+    Machine machine;
+    std::unique_ptr<BlockDevice> disk(new BlockDevice(Address(0x00, DISK_ADDRESS), machine.bus()));
+    std::string error;
+    if (!disk->attach(DISK_IMAGE_FILE, error)) {
+        check(false, "cannot attach the disk image");
+        return;
+    }
+    machine.addDevice(std::move(disk));
+    machine.addRam(1);
+    machine.bus().storeBytes(PROGRAM_ADDRESS, DISK_PROGRAM, sizeof(DISK_PROGRAM));
+
+    Cpu65816::Registers registers = machine.cpu().getRegisters();
+    registers.pbr = 0x00;
+    registers.pc = PROGRAM_ADDRESS;
+    registers.s = 0x01FF;
+    registers.e = 1;
+    machine.cpu().setRESPin(false);
+    machine.cpu().setRegisters(registers);
+
+    Rewind rewind(machine, RUN_CYCLES, CHECKPOINT_COUNT);
+    check(rewind.run(RUN_CYCLES, 0) == StopReason::Stp, "disk program did not reach STP");
+    check(sectorByte(machine, 0) == 0xAA && sectorByte(machine, 1) == 0xBB, "disk program did not write both sectors");
+
+    // Selecting from outside changed the device; go back past it.
+    check(rewind.goTo(0), "goTo the start of the disk program failed");
+    check(sectorByte(machine, 0) == 0x00, "sector 0 was not put back");
+    check(sectorByte(machine, 1) == 0x00, "sector 1 was not put back");
+}
+
+} // namespace
+
+int main() {
+    Log::out(NULL_DEVICE);
+
+    {
+        std::ofstream log(INPUT_LOG_FILE);
+        log << "# dt65pc input log: CYCLE UART BYTE" << std::endl;
+        for (int i = 1; i <= INPUT_BYTES; ++i) {
+            log << i * INPUT_SPACING << " 00:B000 " << 40 + i << std::endl;
+        }
+    }
+    InputLog input;
+    std::string error;
+    if (!input.replay(INPUT_LOG_FILE, error)) {
+        std::printf("rewind65816: %s\n", error.c_str());
+        return 1;
+    }
+
+    UartPC16550D uart(Address(0x00, UART_ADDRESS), 0);
+    uart.setInputLog(&input);
+    Machine machine;
+    machine.addDevice(&uart);
+    machine.addRam(1);
+    machine.bus().storeBytes(PROGRAM_ADDRESS, PROGRAM, sizeof(PROGRAM));
+    machine.bus().storeBytes(SUBROUTINE_ADDRESS, SUBROUTINE, sizeof(SUBROUTINE));
+
+    Cpu65816 &cpu = machine.cpu();
+    Cpu65816::Registers registers = cpu.getRegisters();
+    registers.pbr = 0x00;
+    registers.pc = PROGRAM_ADDRESS;
+    registers.s = 0x01FF;
+    registers.e = 1;
+    cpu.setRESPin(false);
+    cpu.setRegisters(registers);
+
+    // Run forward one instruction at a time, recording each state.
+    Rewind rewind(machine, CHECKPOINT_INTERVAL, CHECKPOINT_COUNT);
+    std::vector<State> history;
+    history.push_back(capture(machine));
+    StopReason reason;
+    do {
+        reason = rewind.run(1, 0);
+        history.push_back(capture(machine));
+    } while (reason == StopReason::CycleBudget && cpu.getTotalCycles() < RUN_CYCLES);
+    check(reason == StopReason::Stp, "program did not reach STP");
+    const uint64_t end = cpu.getTotalInstructions();
+    check(rewind.checkpoints() > 2, "too few checkpoints taken");
+
+    check(rewind.stepBack(), "stepBack failed");
+    checkState(machine, history, "stepBack did not restore the previous instruction");
+
+    // Forward again from the middle: the replayed input must be read again.
+    check(rewind.goTo(end / 2) && cpu.getTotalInstructions() == end / 2, "goTo missed its instruction");
+    checkState(machine, history, "goTo did not restore the state");
+    reason = rewind.run(RUN_CYCLES, STOP_ON_ALL);
+    check(reason == StopReason::Stp && cpu.getTotalInstructions() == end, "running forward again did not repeat the run");
+    checkState(machine, history, "running forward again ended in another state");
+
+    // Back to the last call of the subroutine.
+    machine.breakPoints().add(Address(0x00, SUBROUTINE_ADDRESS));
+    reason = rewind.continueBack();
+    check(reason == StopReason::Breakpoint && cpu.getProgramAddress().getAbsolute() == SUBROUTINE_ADDRESS,
+        "continueBack did not stop at the breakpoint");
+    checkState(machine, history, "continueBack to a breakpoint did not restore the state");
+    machine.breakPoints().remove(Address(0x00, SUBROUTINE_ADDRESS));
+
+    // Back to the store of the third byte.
+    machine.bus().addWatchpoint(Address(0x00, BUFFER_ADDRESS + 2), Address(0x00, BUFFER_ADDRESS + 2), WATCH_WRITE);
+    reason = rewind.continueBack();
+    check(reason == StopReason::Watchpoint && machine.bus().watchpoints().hasHits()
+        && machine.bus().watchpoints().hits().front().address == BUFFER_ADDRESS + 2,
+        "continueBack did not stop at the watchpoint");
+    checkState(machine, history, "continueBack to a watchpoint did not restore the state");
+
+    // Going back only ever goes earlier, so visit the rest newest first.
+    const uint64_t now = cpu.getTotalInstructions();
+    const uint64_t targets[] = { now - 1, now / 2, 1, 0 };
+    for (uint64_t target : targets) {
+        check(rewind.goTo(target) && cpu.getTotalInstructions() == target, "goTo missed its instruction");
+        checkState(machine, history, "goTo did not restore the state");
+    }
+
+    std::remove(INPUT_LOG_FILE);
+
+    {
+        std::ofstream image(DISK_IMAGE_FILE, std::ios::binary);
+        const std::vector<char> zeros(DISK_IMAGE_SECTORS * DISK_SECTOR_SIZE, 0);
+        image.write(zeros.data(), zeros.size());
+    }
+    checkDiskWindow();
+    std::remove(DISK_IMAGE_FILE);
+    if (gFailures) return 1;
+    std::printf("rewind65816: all checks passed\n");
+    return 0;
+}
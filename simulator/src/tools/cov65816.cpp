@@ -0,0 +1,68 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+// Merges coverage maps and reports them against a ca65 listing.
+
+#include <cstring>
+#include <iostream>
+
+#include "Coverage.hpp"
+
+static void usage() {
+    std::cerr << "usage: cov65816 [-o merged] [-l listing] map..." << std::endl
+              << "  -o merged   write the OR of all maps to a new map" << std::endl
+              << "  -l listing  annotate a ca65 listing with the merged coverage" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    const char *output = 0;
+    const char *listing = 0;
+    Coverage coverage;
+    int maps = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "-o") && i + 1 < argc) {
+            output = argv[++i];
+        } else if (!strcmp(arg, "-l") && i + 1 < argc) {
+            listing = argv[++i];
+        } else if (arg[0] != '-') {
+            if (!coverage.load(arg)) {
+                std::cerr << "cov65816: cannot read coverage map " << arg << std::endl;
+                return 1;
+            }
+            ++maps;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (maps == 0 || (!output && !listing)) {
+        usage();
+        return 1;
+    }
+
+    if (output && !coverage.save(output)) {
+        std::cerr << "cov65816: cannot write " << output << std::endl;
+        return 1;
+    }
+    if (listing && !coverage.report(std::cout, listing)) {
+        std::cerr << "cov65816: cannot read listing " << listing << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+
+// Bulk disassembler for ROM and program images.
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include "Disassembler.hpp"
+#include "SystemBusDevice.hpp"
+
+static void usage() {
+    std::cerr << "usage: dis65816 [-b base] [-s start] [-e end] [-m16] [-x16] image" << std::endl
+              << "  -b base   address of the first byte of the image (default 00:0000)" << std::endl
+              << "  -s start  first address to disassemble" << std::endl
+              << "  -e end    address just past the last byte to disassemble" << std::endl
+              << "  -m16      start with a 16-bit accumulator" << std::endl
+              << "  -x16      start with 16-bit index registers" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    Address base(0x00, 0x0000);
+    Address start(0x00, 0x0000);
+    Address end(0x00, 0x0000);
+    bool haveStart = false;
+    bool haveEnd = false;
+    bool m8 = true;
+    bool x8 = true;
+    const char *filename = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if ((!strcmp(arg, "-b") || !strcmp(arg, "-s") || !strcmp(arg, "-e")) && i + 1 < argc) {
+            Address &target = arg[1] == 'b' ? base : arg[1] == 's' ? start : end;
+            if (!Address::parse(argv[++i], target)) {
+                std::cerr << "dis65816: bad address " << argv[i] << std::endl;
+                return 1;
+            }
+            haveStart |= arg[1] == 's';
+            haveEnd |= arg[1] == 'e';
+        } else if (!strcmp(arg, "-m16")) {
+            m8 = false;
+        } else if (!strcmp(arg, "-x16")) {
+            x8 = false;
+        } else if (arg[0] != '-' && !filename) {
+            filename = arg;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (!filename) {
+        usage();
+        return 1;
+    }
+
+    std::ifstream infile(filename, std::ios_base::binary);
+    if (!infile) {
+        std::cerr << "dis65816: cannot open " << filename << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> image((std::istreambuf_iterator<char>(infile)),
+                               std::istreambuf_iterator<char>());
+
+    // Clip the requested range to the image.
+    const uint32_t first = base.getAbsolute();
+    const uint32_t last = first + image.size();
+    uint32_t from = haveStart ? start.getAbsolute() : first;
+    uint32_t to = haveEnd ? end.getAbsolute() : last;
+    if (from < first) from = first;
+    if (to > last) to = last;
+    if (from >= to) return 0;
+
+    std::ios_base::sync_with_stdio(false);
+    Disassembler::disassemble(image.data() + (from - first), to - from, from, m8, x8, std::cout);
+    return 0;
+}
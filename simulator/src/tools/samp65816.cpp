@@ -0,0 +1,70 @@
+// Copyright (C) 2026 David Terhune
+//
+// This file is part of dt65pc.
+// https://github.com/RagudMezegiz/dt65pc
+//
+// dt65pc is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dt65pc is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dt65pc.  If not, see <http://www.gnu.org/licenses/>.
+// Reports sample buffers written by the sampling profiler.
+
+#include <cstring>
+#include <iostream>
+
+#include "Sampler.hpp"
+#include "Symbols.hpp"
+
+static void usage() {
+    std::cerr << "usage: samp65816 [-s symbols]... [-c] samples..." << std::endl
+              << "  -s symbols  name addresses from an ld65 label (.lbl) or map (.map) file" << std::endl
+              << "              or a ca65 listing (.lst)" << std::endl
+              << "  -c          write sample counts per call path in collapsed-stack form" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    Symbols symbols;
+    Sampler sampler;
+    bool collapsed = false;
+    int buffers = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "-s") && i + 1 < argc) {
+            if (!symbols.load(argv[++i])) {
+                std::cerr << "samp65816: cannot read symbols from " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!strcmp(arg, "-c")) {
+            collapsed = true;
+        } else if (arg[0] != '-') {
+            if (!sampler.load(arg)) {
+                std::cerr << "samp65816: cannot read samples from " << arg << std::endl;
+                return 1;
+            }
+            ++buffers;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (buffers == 0) {
+        usage();
+        return 1;
+    }
+
+    if (collapsed) {
+        sampler.writeCollapsed(std::cout, symbols);
+    } else {
+        sampler.report(std::cout, symbols);
+    }
+    return 0;
+}